@@ -0,0 +1,13 @@
+{
+  'targets': [
+    {
+      'target_name': 'nodeproxy_bench',
+      'sources': [
+        'src/bench.cc',
+      ],
+      "include_dirs" : [
+        "<!(node -e \"require('nan')\")"
+      ],
+    }
+  ]
+}
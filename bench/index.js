@@ -0,0 +1,350 @@
+/*jslint forin: true, onevar: true, immed: true */
+
+/*
+ *  Runs every benchmark case against a proxy and against a plain
+ *  object doing the same work, and prints the results as JSON.
+ *
+ *  Usage: node --expose-gc bench/index.js [options]
+ *
+ *    --iterations N    operations per case, default 100000
+ *    --filter text     only run the cases whose name contains text
+ *    --save file       write the results to file, to be used as a baseline
+ *    --baseline file   compare against a saved run, exit 1 on regressions
+ *    --threshold n     allowed slowdown against the baseline, default 0.25
+ *
+ *  Build the timing helper first with `node-gyp rebuild -C bench`,
+ *  without it process.hrtime is used and bytes/op is not reported.
+ */
+(function () {
+  var Proxy = require("../lib/node-proxy.js"),
+    fs = require("fs"),
+    path = require("path"),
+    args = {},
+    helper,
+    now,
+    allocated = null,
+    cases,
+    sink,
+    i;
+
+  for (i = 2; i < process.argv.length; i += 2) {
+    args[process.argv[i].replace(/^--/, "")] = process.argv[i + 1];
+  }
+
+  args.iterations = parseInt(args.iterations, 10) || 100000;
+  args.threshold = parseFloat(args.threshold) || 0.25;
+
+  try {
+    helper = require("bindings")({
+      bindings: "nodeproxy_bench.node",
+      module_root: __dirname
+    });
+    now = helper.now;
+    // the first call installs the GC hooks that count allocations
+    allocated = helper.allocated;
+    allocated();
+  } catch (e) {
+    now = function () {
+      var t = process.hrtime();
+      return t[0] * 1e9 + t[1];
+    };
+  }
+
+  if (typeof gc !== "function") {
+    console.error("run with --expose-gc to get stable numbers");
+    process.exit(1);
+  }
+
+  function handler() {
+    var store = { first: 1 };
+
+    return {
+      get: function (receiver, name) {
+        return store[name];
+      },
+      set: function (receiver, name, value) {
+        store[name] = value;
+        return true;
+      },
+      has: function (name) {
+        return name in store;
+      },
+      "delete": function (name) {
+        return delete store[name];
+      },
+      enumerate: function () {
+        return Object.keys(store);
+      },
+      defineProperty: function (name, pd) {
+        store[name] = pd.value;
+        return true;
+      },
+      fix: function () {
+        return {};
+      }
+    };
+  }
+
+  // a proxy whose fix trap returns the property get serves
+  function fixed(options) {
+    return Proxy.create({
+      get: function (receiver, name) {
+        return 1;
+      },
+      fix: function () {
+        return {
+          first: { value: 1, writable: true, enumerable: true, configurable: true }
+        };
+      }
+    }, undefined, options);
+  }
+
+  function callTrap(a, b, c) {
+    return a;
+  }
+
+  function ConstructTrap(a, b, c) {
+    this.a = a;
+  }
+
+  // every case does the same work on a plain object and on a proxy
+  cases = (function () {
+    var proxy = Proxy.create(handler()),
+      // traps returning constants, so the bytes/op beyond the plain case
+      // are those of the interceptors and of calling the trap
+      constant = Proxy.create({
+        get: function (receiver, name) {
+          return 1;
+        },
+        set: function (receiver, name, value) {
+          return true;
+        }
+      }),
+      plain = { first: 1 },
+      fn = Proxy.createFunction(handler(), callTrap, ConstructTrap),
+      descriptor = { value: 1, writable: true, enumerable: true, configurable: true },
+      descriptors = { first: descriptor, second: descriptor },
+      elements = new Float64Array(8),
+      view = Proxy.createArrayView(handler(), elements),
+      record = { x: 1.5 },
+      struct = Proxy.createStruct({ x: "f64@0" }, new ArrayBuffer(8)),
+      hidden = {},
+      frozenPlain = Object.freeze({ first: 1 }),
+      frozen = fixed(),
+      materialized = fixed({ materialize: true }),
+      // a materialized proxy returns a plain copy when it is frozen
+      copy;
+
+    Proxy.freeze(frozen);
+    copy = Proxy.freeze(materialized);
+
+    return {
+      "named get": {
+        plain: function () { sink = plain.first; },
+        proxy: function () { sink = proxy.first; }
+      },
+      "named set": {
+        plain: function () { plain.first = 1; },
+        proxy: function () { proxy.first = 1; }
+      },
+      "named has": {
+        plain: function () { sink = "first" in plain; },
+        proxy: function () { sink = "first" in proxy; }
+      },
+      "named delete": {
+        plain: function () { delete plain.second; },
+        proxy: function () { delete proxy.second; }
+      },
+      "constant trap get": {
+        plain: function () { sink = plain.first; },
+        proxy: function () { sink = constant.first; }
+      },
+      "constant trap set": {
+        plain: function () { plain.first = 1; },
+        proxy: function () { constant.first = 1; }
+      },
+      "indexed get": {
+        plain: function () { sink = plain[0]; },
+        proxy: function () { sink = proxy[0]; }
+      },
+      "indexed set": {
+        plain: function () { plain[0] = 1; },
+        proxy: function () { proxy[0] = 1; }
+      },
+      "indexed has": {
+        plain: function () { sink = 0 in plain; },
+        proxy: function () { sink = 0 in proxy; }
+      },
+      "indexed delete": {
+        plain: function () { delete plain[1]; },
+        proxy: function () { delete proxy[1]; }
+      },
+      "array view get": {
+        plain: function () { sink = elements[3]; },
+        proxy: function () { sink = view[3]; }
+      },
+      "array view set": {
+        plain: function () { elements[3] = 1.5; },
+        proxy: function () { view[3] = 1.5; }
+      },
+      "struct get": {
+        plain: function () { sink = record.x; },
+        proxy: function () { sink = struct.x; }
+      },
+      "struct set": {
+        plain: function () { record.x = 1.5; },
+        proxy: function () { struct.x = 1.5; }
+      },
+      "getMany": {
+        plain: function () { sink = [plain.first, plain.first, plain.first]; },
+        proxy: function () { sink = Proxy.getMany(proxy, ["first", "first", "first"]); }
+      },
+      "enumerate": {
+        plain: function () { sink = Object.keys(plain); },
+        proxy: function () { sink = Object.keys(proxy); }
+      },
+      "function call": {
+        plain: function () { sink = callTrap(1, 2, 3); },
+        proxy: function () { sink = fn(1, 2, 3); }
+      },
+      "function call, 20 arguments": {
+        plain: function () {
+          sink = callTrap(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20);
+        },
+        proxy: function () {
+          sink = fn(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20);
+        }
+      },
+      "function construct": {
+        plain: function () { sink = new ConstructTrap(1, 2, 3); },
+        proxy: function () { sink = new fn(1, 2, 3); }
+      },
+      "freeze": {
+        plain: function () { sink = Object.freeze({}); },
+        proxy: function () { sink = Proxy.freeze(Proxy.create(handler())); }
+      },
+      "frozen read": {
+        plain: function () { sink = frozenPlain.first; },
+        proxy: function () { sink = frozen.first; }
+      },
+      "materialized frozen read": {
+        plain: function () { sink = frozenPlain.first; },
+        proxy: function () { sink = materialized.first; }
+      },
+      "materialized copy read": {
+        plain: function () { sink = frozenPlain.first; },
+        proxy: function () { sink = copy.first; }
+      },
+      "defineProperty": {
+        plain: function () { sink = Object.defineProperty(plain, "first", descriptor); },
+        proxy: function () { sink = Proxy.defineProperty(proxy, "first", descriptor); }
+      },
+      "defineProperties": {
+        plain: function () { sink = Object.defineProperties(plain, descriptors); },
+        proxy: function () { sink = Proxy.defineProperties(proxy, descriptors); }
+      },
+      "clone": {
+        plain: function () {
+          var copy = {}, name;
+          for (name in plain) {
+            copy[name] = plain[name];
+          }
+          sink = copy;
+        },
+        proxy: function () { sink = Proxy.clone(plain); }
+      },
+      "hidden": {
+        plain: function () { hidden.value = 1; sink = hidden.value; },
+        proxy: function () { Proxy.hidden(hidden, "value", 1); sink = Proxy.hidden(hidden, "value"); }
+      }
+    };
+  }());
+
+  function measure(fn) {
+    var n = args.iterations, j, before, after, start, elapsed;
+
+    // warm up so that inline caches and lazy compilation are settled
+    for (j = 0; j < 1000; ++j) {
+      fn();
+    }
+
+    gc();
+    before = allocated !== null ? allocated() : 0;
+    start = now();
+
+    for (j = 0; j < n; ++j) {
+      fn();
+    }
+
+    elapsed = now() - start;
+    after = allocated !== null ? allocated() : 0;
+
+    // bytes allocated, including those scavenges freed during the loop,
+    // a difference of heapUsed would lose them
+    return {
+      nsPerOp: elapsed / n,
+      bytesPerOp: allocated !== null ? (after - before) / n : null
+    };
+  }
+
+  function compare(results, baseline) {
+    var regressions = [], name, was, is;
+
+    for (name in results) {
+      if (!baseline.results[name]) {
+        continue;
+      }
+
+      // compare against the plain case of each run, so that
+      // baselines from a different machine stay meaningful
+      was = baseline.results[name].ratio;
+      is = results[name].ratio;
+
+      if (is > was * (1 + args.threshold)) {
+        regressions.push({ name: name, baseline: was, current: is });
+      }
+    }
+
+    return regressions;
+  }
+
+  (function () {
+    var results = {}, report, name, plain, proxy, baseline;
+
+    for (name in cases) {
+      if (args.filter && name.indexOf(args.filter) < 0) {
+        continue;
+      }
+
+      plain = measure(cases[name].plain);
+      proxy = measure(cases[name].proxy);
+
+      results[name] = {
+        plain: plain,
+        proxy: proxy,
+        ratio: plain.nsPerOp > 0 ? proxy.nsPerOp / plain.nsPerOp : 0
+      };
+    }
+
+    report = {
+      node: process.version,
+      iterations: args.iterations,
+      results: results
+    };
+
+    if (args.baseline) {
+      baseline = JSON.parse(fs.readFileSync(path.resolve(args.baseline), "utf8"));
+      report.regressions = compare(results, baseline);
+    }
+
+    if (args.save) {
+      fs.writeFileSync(path.resolve(args.save), JSON.stringify(report, null, 2) + "\n");
+    }
+
+    console.log(JSON.stringify(report, null, 2));
+
+    if (report.regressions && report.regressions.length) {
+      process.exit(1);
+    }
+  }());
+}());
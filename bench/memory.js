@@ -0,0 +1,183 @@
+/*jslint forin: true, onevar: true, immed: true */
+
+/*
+ *  Measures the heap retained by each live proxy and the garbage
+ *  collection pauses caused while creating and replacing them,
+ *  for several handler configurations, and prints the results as JSON.
+ *
+ *  Usage: node --expose-gc bench/memory.js [options]
+ *
+ *    --counts list     comma separated proxy counts, default 100000,1000000
+ *    --rounds n        times every proxy is replaced, default 1
+ *    --filter text     only run the configurations whose name contains text
+ *
+ *  Large counts need a larger heap, e.g. --max-old-space-size=8192 for 10000000.
+ *  GC pauses are only reported when the helper built by
+ *  `node-gyp rebuild -C bench` is available.
+ */
+(function () {
+  var Proxy = require("../lib/node-proxy.js"),
+    args = {},
+    helper = null,
+    heapUsed,
+    configurations,
+    i;
+
+  for (i = 2; i < process.argv.length; i += 2) {
+    args[process.argv[i].replace(/^--/, "")] = process.argv[i + 1];
+  }
+
+  args.counts = (args.counts || "100000,1000000").split(",").map(Number);
+  args.rounds = parseInt(args.rounds, 10) || 1;
+
+  try {
+    helper = require("bindings")({
+      bindings: "nodeproxy_bench.node",
+      module_root: __dirname
+    });
+    heapUsed = helper.heapUsed;
+  } catch (e) {
+    heapUsed = function () {
+      return process.memoryUsage().heapUsed;
+    };
+  }
+
+  if (typeof gc !== "function") {
+    console.error("run with --expose-gc to get stable numbers");
+    process.exit(1);
+  }
+
+  function getOnly() {
+    return {
+      get: function (receiver, name) {
+        return name;
+      }
+    };
+  }
+
+  function callTrap() {
+    return 1;
+  }
+
+  // each configuration returns a function creating one proxy
+  configurations = {
+    "create, shared handler": function () {
+      var handler = getOnly();
+      return function () {
+        return Proxy.create(handler);
+      };
+    },
+    "create, handler per proxy": function () {
+      return function () {
+        return Proxy.create(getOnly());
+      };
+    },
+    "create, named only": function () {
+      var handler = getOnly(), options = { indexed: false };
+      return function () {
+        return Proxy.create(handler, undefined, options);
+      };
+    },
+    "create, with ignore list": function () {
+      var handler = getOnly(), options = { ignore: ["then", "inspect"] };
+      return function () {
+        return Proxy.create(handler, undefined, options);
+      };
+    },
+    "createFunction, shared handler": function () {
+      var handler = getOnly();
+      return function () {
+        return Proxy.createFunction(handler, callTrap);
+      };
+    },
+    "createFunction, handler per proxy": function () {
+      return function () {
+        return Proxy.createFunction(getOnly(), callTrap);
+      };
+    },
+    "createForwarding, shared handler": function () {
+      var handler = getOnly(), target = {};
+      return function () {
+        return Proxy.createForwarding(target, handler);
+      };
+    }
+  };
+
+  function pauses() {
+    return helper ? helper.gcPauses() : null;
+  }
+
+  function measure(make, count) {
+    var live = new Array(count), j, round, before, after, start, created, churned;
+
+    for (j = 0; j < count; ++j) {
+      live[j] = null;
+    }
+
+    gc();
+    pauses();
+    before = heapUsed();
+    start = Date.now();
+
+    for (j = 0; j < count; ++j) {
+      live[j] = make();
+    }
+
+    created = {
+      ms: Date.now() - start,
+      gc: pauses()
+    };
+
+    gc();
+    pauses();
+    after = heapUsed();
+    start = Date.now();
+
+    // replace every proxy, so the old ones die while new ones are made
+    for (round = 0; round < args.rounds; ++round) {
+      for (j = 0; j < count; ++j) {
+        live[j] = make();
+      }
+    }
+
+    churned = {
+      ms: Date.now() - start,
+      gc: pauses()
+    };
+
+    live = null;
+    gc();
+
+    return {
+      count: count,
+      bytesPerProxy: Math.max(0, after - before) / count,
+      create: created,
+      churn: churned
+    };
+  }
+
+  (function () {
+    var results = {}, name, runs, make;
+
+    for (name in configurations) {
+      if (args.filter && name.indexOf(args.filter) < 0) {
+        continue;
+      }
+
+      runs = [];
+
+      for (i = 0; i < args.counts.length; ++i) {
+        make = configurations[name]();
+        runs.push(measure(make, args.counts[i]));
+      }
+
+      results[name] = runs;
+    }
+
+    console.log(JSON.stringify({
+      node: process.version,
+      rounds: args.rounds,
+      results: results
+    }, null, 2));
+  }());
+}());
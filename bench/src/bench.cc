@@ -0,0 +1,178 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#include <uv.h>
+#include <node.h>
+#include "nan.h"
+
+using v8::Local;
+using v8::Object;
+using v8::FunctionTemplate;
+using v8::HeapStatistics;
+
+/**
+ *  Timing and heap helpers for the benchmark runner, kept out of
+ *  the module itself so that measuring never changes what is measured
+ *
+ */
+
+/**
+ *  A monotonic timestamp, without the Array process.hrtime allocates
+ *
+ *  @returns Number - nanoseconds
+ */
+NAN_METHOD(Now) {
+  info.GetReturnValue().Set(Nan::New<v8::Number>(
+      static_cast<double>(uv_hrtime())));
+}
+
+static double UsedHeapSize() {
+  HeapStatistics stats;
+  Nan::GetHeapStatistics(&stats);
+
+  return static_cast<double>(stats.used_heap_size());
+}
+
+/**
+ *  The bytes currently used by the JS heap, without the
+ *  Object process.memoryUsage allocates
+ *
+ *  @returns Number
+ */
+NAN_METHOD(HeapUsed) {
+  info.GetReturnValue().Set(Nan::New<v8::Number>(UsedHeapSize()));
+}
+
+// pause statistics of one kind of collection
+struct PauseStats {
+  double count;
+  double total;
+  double max;
+};
+
+static PauseStats scavenges;
+static PauseStats markCompacts;
+static uint64_t gcStart;
+static bool gcHooked = false;
+
+// the bytes every collection so far has freed, with the heap in
+// use this adds up to the bytes allocated since the hooks were added
+static double gcFreed = 0;
+static double gcUsedBefore;
+
+static NAN_GC_CALLBACK(BeforeGC) {
+  gcUsedBefore = UsedHeapSize();
+  gcStart = uv_hrtime();
+}
+
+static NAN_GC_CALLBACK(AfterGC) {
+  double pause = static_cast<double>(uv_hrtime() - gcStart) / 1e6;
+  double used = UsedHeapSize();
+  PauseStats *stats = type == v8::kGCTypeScavenge ? &scavenges : &markCompacts;
+
+  if (gcUsedBefore > used) {
+    gcFreed += gcUsedBefore - used;
+  }
+
+  stats->count += 1;
+  stats->total += pause;
+
+  if (pause > stats->max) {
+    stats->max = pause;
+  }
+}
+
+static Local<Object> PauseReport(const PauseStats &stats) {
+  Local<Object> report = Nan::New<Object>();
+
+  Nan::Set(report, Nan::New<v8::String>("count").ToLocalChecked(),
+      Nan::New<v8::Number>(stats.count));
+  Nan::Set(report, Nan::New<v8::String>("totalMs").ToLocalChecked(),
+      Nan::New<v8::Number>(stats.total));
+  Nan::Set(report, Nan::New<v8::String>("maxMs").ToLocalChecked(),
+      Nan::New<v8::Number>(stats.max));
+
+  return report;
+}
+
+static void HookGC() {
+  if (!gcHooked) {
+    Nan::AddGCPrologueCallback(BeforeGC);
+    Nan::AddGCEpilogueCallback(AfterGC);
+    gcHooked = true;
+  }
+}
+
+/**
+ *  Report the garbage collection pauses since the last call,
+ *  the first call starts recording them
+ *
+ *  @returns Object - { scavenge, markCompact } of { count, totalMs, maxMs }
+ */
+NAN_METHOD(GCPauses) {
+  HookGC();
+
+  Local<Object> report = Nan::New<Object>();
+
+  Nan::Set(report, Nan::New<v8::String>("scavenge").ToLocalChecked(),
+      PauseReport(scavenges));
+  Nan::Set(report, Nan::New<v8::String>("markCompact").ToLocalChecked(),
+      PauseReport(markCompacts));
+
+  scavenges = PauseStats();
+  markCompacts = PauseStats();
+
+  info.GetReturnValue().Set(report);
+}
+
+/**
+ *  The bytes allocated on the JS heap since the first call, counted
+ *  across collections, unlike the difference of two heapUsed calls
+ *  which a scavenge in between makes meaningless
+ *
+ *  @returns Number
+ */
+NAN_METHOD(Allocated) {
+  HookGC();
+
+  info.GetReturnValue().Set(Nan::New<v8::Number>(UsedHeapSize() + gcFreed));
+}
+
+void init(Local<Object> exports) {
+  Nan::Set(exports, Nan::New<v8::String>("now").ToLocalChecked(),
+      Nan::GetFunction(Nan::New<FunctionTemplate>(Now)).ToLocalChecked());
+  Nan::Set(exports, Nan::New<v8::String>("heapUsed").ToLocalChecked(),
+      Nan::GetFunction(Nan::New<FunctionTemplate>(HeapUsed)).ToLocalChecked());
+  Nan::Set(exports, Nan::New<v8::String>("allocated").ToLocalChecked(),
+      Nan::GetFunction(Nan::New<FunctionTemplate>(Allocated)).ToLocalChecked());
+  Nan::Set(exports, Nan::New<v8::String>("gcPauses").ToLocalChecked(),
+      Nan::GetFunction(Nan::New<FunctionTemplate>(GCPauses)).ToLocalChecked());
+}
+
+NODE_MODULE(nodeproxy_bench, init)
@@ -1,4 +1,8 @@
 {
+  'variables': {
+    # set to 0 to build without the USDT probes, @see src/probes.h
+    'node_proxy_sdt%': 1
+  },
   'targets': [
     {
       'target_name': 'nodeproxy',
@@ -8,6 +12,11 @@
       "include_dirs" : [
         "<!(node -e \"require('nan')\")"
       ],
+      'conditions': [
+        ['node_proxy_sdt==0', {
+          'defines': [ 'NODE_PROXY_NO_SDT' ]
+        }]
+      ],
     }
   ]
 }
@@ -0,0 +1,431 @@
+/*jslint forin: true, onevar: true, immed: true */
+
+/*
+ *  Runs node-proxy handlers on the built-in ES Proxy.
+ *
+ *  The Harmony handler API is mapped onto ES Proxy traps the same way
+ *  the native interceptors dispatch it: get falls back to getValue,
+ *  getPropertyDescriptor and then getOwnPropertyDescriptor, set to
+ *  setValue, getOwnPropertyDescriptor and then getPropertyDescriptor,
+ *  has to hasOwn, has and the descriptor traps, and enumeration to
+ *  enumerate, keys and then getPropertyNames. Locking a proxy calls
+ *  the fix trap and defines the returned descriptors on the target,
+ *  after which every trap is answered by the target, as the Harmony
+ *  proposal specifies. Symbol keys never reach the handler.
+ */
+var EsProxy = typeof Proxy === "function" ? Proxy : null,
+  available = EsProxy !== null && typeof Reflect === "object" && typeof WeakMap === "function",
+  // the state of every proxy made here, keyed by the proxy
+  states = available ? new WeakMap() : null,
+  // the most indices an indexRange may span, as on the native side
+  MAX_INDEX_RANGE = 0x7fffffff;
+
+function trap(state, name) {
+  var fn = state.handler[name];
+  return typeof fn === "function" ? fn : null;
+}
+
+// the descriptor of the first of two descriptor traps the handler has,
+// get tries getPropertyDescriptor first and set getOwnPropertyDescriptor,
+// as HandlerRecord::Resolve orders them
+function descriptorOf(state, name, first, second) {
+  var fn = trap(state, first) || trap(state, second);
+  return fn ? fn.call(state.handler, name) : undefined;
+}
+
+function isObject(value) {
+  return value !== null && (typeof value === "object" || typeof value === "function");
+}
+
+function valueOf(desc, receiver, name) {
+  if (!desc || typeof desc !== "object") {
+    return undefined;
+  }
+
+  return typeof desc.get === "function" ? desc.get.call(receiver, name) : desc.value;
+}
+
+// the names of an enumeration trap result, an Array or an iterator
+// yielding names or Arrays of names, as the native side accepts
+function listOf(result) {
+  var names, step, i;
+
+  if (Array.isArray(result)) {
+    return result;
+  }
+
+  names = [];
+
+  if (result === null || typeof result !== "object" || typeof result.next !== "function") {
+    return names;
+  }
+
+  for (step = result.next(); step && !step.done; step = result.next()) {
+    if (Array.isArray(step.value)) {
+      for (i = 0; i < step.value.length; ++i) {
+        names.push(step.value[i]);
+      }
+    } else {
+      names.push(step.value);
+    }
+  }
+
+  return names;
+}
+
+function namesOf(state) {
+  var fn = trap(state, "enumerate") || trap(state, "keys") || trap(state, "getPropertyNames"),
+    names = fn ? listOf(fn.call(state.handler)) : [],
+    seen = {},
+    result = [],
+    i;
+
+  for (i = 0; i < names.length; ++i) {
+    if (!seen.hasOwnProperty(names[i])) {
+      seen[names[i]] = true;
+      result.push(String(names[i]));
+    }
+  }
+
+  return result;
+}
+
+// the [start, end) range returned by indexRange, or null
+function rangeOf(state) {
+  var fn = trap(state, "indexRange"),
+    range = fn ? fn.call(state.handler) : null;
+
+  if (!Array.isArray(range) || range.length < 2 ||
+      range[0] !== range[0] >>> 0 || range[1] !== range[1] >>> 0 || range[0] > range[1]) {
+    return null;
+  }
+
+  if (range[1] - range[0] > MAX_INDEX_RANGE) {
+    throw new RangeError("indexRange may span at most " + MAX_INDEX_RANGE + " indices.");
+  }
+
+  return range;
+}
+
+function inRange(state, name) {
+  var range = rangeOf(state), index = Number(name);
+
+  return range !== null && String(index >>> 0) === name &&
+         index >= range[0] && index < range[1];
+}
+
+// own properties of the target the built-in Proxy does not let
+// a trap hide or change, like the prototype of a function target
+function pinned(target, name) {
+  var desc = Reflect.getOwnPropertyDescriptor(target, name);
+  return desc !== undefined && !desc.configurable;
+}
+
+// the built-in Proxy enforces its invariants against the target,
+// which only holds what fix returned, so nothing else may be reported
+// as non-configurable
+function normalize(desc) {
+  var result = {}, name;
+
+  for (name in desc) {
+    result[name] = desc[name];
+  }
+
+  result.configurable = true;
+
+  return result;
+}
+
+function traps(state) {
+  return {
+    get: function (target, name, receiver) {
+      var fn, range;
+
+      if (state.fixed || typeof name === "symbol") {
+        return Reflect.get(target, name, receiver);
+      }
+
+      if (name === "length" && (range = rangeOf(state)) !== null) {
+        return range[1];
+      }
+
+      fn = trap(state, "get");
+
+      if (fn) {
+        return fn.call(state.handler, receiver, name);
+      }
+
+      fn = trap(state, "getValue");
+
+      if (fn) {
+        return fn.call(state.handler, name);
+      }
+
+      return valueOf(descriptorOf(state, name, "getPropertyDescriptor",
+                                  "getOwnPropertyDescriptor"), receiver, name);
+    },
+
+    set: function (target, name, value, receiver) {
+      var fn, desc;
+
+      if (state.fixed || typeof name === "symbol") {
+        return Reflect.set(target, name, value, receiver);
+      }
+
+      fn = trap(state, "set");
+
+      if (fn) {
+        fn.call(state.handler, receiver, name, value);
+        return true;
+      }
+
+      fn = trap(state, "setValue");
+
+      if (fn) {
+        fn.call(state.handler, name, value);
+        return true;
+      }
+
+      desc = descriptorOf(state, name, "getOwnPropertyDescriptor", "getPropertyDescriptor");
+
+      // like the native side, a writable descriptor only
+      // takes the value, the handler decides what it means
+      if (desc && typeof desc === "object") {
+        if (typeof desc.set === "function") {
+          desc.set.call(receiver, name, value);
+        } else if (desc.writable) {
+          desc.value = value;
+        }
+      }
+
+      return true;
+    },
+
+    has: function (target, name) {
+      var fn;
+
+      if (state.fixed || typeof name === "symbol") {
+        return Reflect.has(target, name);
+      }
+
+      fn = trap(state, "hasOwn") || trap(state, "has");
+
+      if (fn) {
+        return !!fn.call(state.handler, name);
+      }
+
+      // an object from getOwnPropertyDescriptor, else
+      // one from getPropertyDescriptor, means present
+      fn = trap(state, "getOwnPropertyDescriptor");
+
+      if (fn && isObject(fn.call(state.handler, name))) {
+        return true;
+      }
+
+      fn = trap(state, "getPropertyDescriptor");
+
+      return fn ? isObject(fn.call(state.handler, name)) : false;
+    },
+
+    deleteProperty: function (target, name) {
+      var fn;
+
+      if (state.fixed || typeof name === "symbol" || pinned(target, name)) {
+        return Reflect.deleteProperty(target, name);
+      }
+
+      fn = trap(state, "delete");
+
+      return fn ? !!fn.call(state.handler, name) : false;
+    },
+
+    ownKeys: function (target) {
+      var keys = Reflect.ownKeys(target), range, names, seen, i;
+
+      if (state.fixed) {
+        return keys;
+      }
+
+      // the indices of indexRange, then the handler names,
+      // then whatever the target holds
+      range = rangeOf(state);
+      names = [];
+      seen = new Set();
+
+      if (range !== null) {
+        for (i = range[0]; i < range[1]; ++i) {
+          names.push(String(i));
+          seen.add(names[names.length - 1]);
+        }
+      }
+
+      keys = namesOf(state).concat(keys);
+
+      for (i = 0; i < keys.length; ++i) {
+        if (!seen.has(keys[i])) {
+          seen.add(keys[i]);
+          names.push(keys[i]);
+        }
+      }
+
+      return names;
+    },
+
+    getOwnPropertyDescriptor: function (target, name) {
+      var desc, fn;
+
+      if (state.fixed || typeof name === "symbol" || pinned(target, name)) {
+        return Reflect.getOwnPropertyDescriptor(target, name);
+      }
+
+      fn = trap(state, "getOwnPropertyDescriptor");
+
+      if (fn) {
+        desc = fn.call(state.handler, name);
+        return desc === undefined ? undefined : normalize(desc);
+      }
+
+      // without descriptors, report what the other traps expose
+      if (namesOf(state).indexOf(name) < 0 && !inRange(state, name)) {
+        return undefined;
+      }
+
+      return {
+        value: this.get(target, name, state.proxy),
+        writable: true,
+        enumerable: true,
+        configurable: true
+      };
+    },
+
+    defineProperty: function (target, name, desc) {
+      var fn;
+
+      if (state.fixed || typeof name === "symbol" || pinned(target, name)) {
+        return Reflect.defineProperty(target, name, desc);
+      }
+
+      fn = trap(state, "defineProperty");
+
+      return fn ? fn.call(state.handler, name, desc) !== false : false;
+    },
+
+    preventExtensions: function (target) {
+      return lock(state, "preventExtensions");
+    },
+
+    isExtensible: function (target) {
+      return Reflect.isExtensible(target);
+    },
+
+    apply: function (target, context, args) {
+      return state.callTrap.apply(context, args);
+    },
+
+    construct: function (target, args, newTarget) {
+      var fn = state.constructTrap || state.callTrap,
+        prototype = state.proxy.prototype,
+        self = Object.create(prototype !== null && typeof prototype === "object" ? prototype : Object.prototype),
+        result = fn.apply(self, args);
+
+      return result !== null && (typeof result === "object" || typeof result === "function") ? result : self;
+    }
+  };
+}
+
+// call the fix trap and move its descriptors onto the target,
+// from then on the target answers every trap
+function lock(state, kind) {
+  var pieces, name;
+
+  if (!state.fixed) {
+    if (!trap(state, "fix")) {
+      throw new TypeError("Cannot lock object.");
+    }
+
+    pieces = state.handler.fix();
+
+    if (pieces === undefined || pieces === null || typeof pieces !== "object") {
+      throw new TypeError("Cannot lock object.");
+    }
+
+    for (name in pieces) {
+      Object.defineProperty(state.target, name, pieces[name]);
+    }
+
+    state.fixed = true;
+    // the handler is no longer needed, leave it for the GC
+    state.handler = null;
+  }
+
+  Object[kind](state.target);
+
+  return true;
+}
+
+function make(handler, target, callTrap, constructTrap) {
+  var state = {
+      handler: handler,
+      target: target,
+      callTrap: callTrap,
+      constructTrap: constructTrap,
+      fixed: false,
+      proxy: null
+    };
+
+  state.proxy = new EsProxy(target, traps(state));
+  states.set(state.proxy, state);
+
+  return state.proxy;
+}
+
+exports.available = available;
+
+exports.create = function (handler, proto) {
+  return make(handler, Object.create(proto === undefined ? Object.prototype : proto));
+};
+
+exports.createFunction = function (handler, callTrap, constructTrap) {
+  var target = function () {};
+
+  Object.setPrototypeOf(target, Object.getPrototypeOf(callTrap));
+
+  return make(handler, target, callTrap, constructTrap);
+};
+
+exports.isProxy = function (obj) {
+  return available && obj !== null &&
+         (typeof obj === "object" || typeof obj === "function") &&
+         states.has(obj);
+};
+
+exports.lock = function (obj, kind) {
+  return lock(states.get(obj), kind);
+};
+
+// a single call to the getMany or setMany trap, or undefined
+// when the handler has none or it did not answer the batch
+exports.getMany = function (obj, names) {
+  var state = states.get(obj),
+    fn = state.fixed ? null : trap(state, "getMany"),
+    values = fn ? fn.call(state.handler, names) : null;
+
+  return Array.isArray(values) ? values : undefined;
+};
+
+exports.setMany = function (obj, entries) {
+  var state = states.get(obj),
+    fn = state.fixed ? null : trap(state, "setMany");
+
+  if (!fn) {
+    return undefined;
+  }
+
+  fn.call(state.handler, entries);
+
+  return true;
+};
+
+exports.isTrapping = function (obj) {
+  return !states.get(obj).fixed;
+};
@@ -1 +1,234 @@
-module.exports = exports = require('bindings')('nodeproxy.node');
+/*jslint forin: true, onevar: true, immed: true */
+
+/*
+ *  Loads the native module and lets create and createFunction run
+ *  the same handlers on the built-in ES Proxy instead, through the
+ *  adapter in es-proxy.js. The backend is chosen per call with the
+ *  backend option, or for every call with Proxy.setBackend.
+ */
+var binding = require('bindings')('nodeproxy.node'),
+  adapter = require('./es-proxy.js'),
+  backends = { "native": true, "es": true, "auto": true },
+  // the backend used when a call does not pass one, "auto" is
+  // kept as is so that it can still pick native for an option
+  backend = "native",
+  // the winner of the one time "auto" measurement
+  measured = null,
+  name;
+
+for (name in binding) {
+  exports[name] = binding[name];
+}
+
+// time gets through each backend and keep the faster one
+function measure() {
+  var handler = {
+      get: function (receiver, name) {
+        return name;
+      }
+    },
+    proxies = {
+      "native": binding.create(handler),
+      "es": adapter.create(handler)
+    },
+    times = {},
+    sink,
+    kind,
+    start,
+    t,
+    i;
+
+  for (kind in proxies) {
+    for (i = 0; i < 1000; ++i) {
+      sink = proxies[kind].tester;
+    }
+
+    start = process.hrtime();
+
+    for (i = 0; i < 20000; ++i) {
+      sink = proxies[kind].tester;
+      sink = proxies[kind][i & 7];
+    }
+
+    t = process.hrtime(start);
+    times[kind] = t[0] * 1e9 + t[1];
+  }
+
+  return times.es < times["native"] ? "es" : "native";
+}
+
+// the first option other than backend that is set, which
+// only the native backend implements, or null
+function nativeOption(options) {
+  var option;
+
+  if (options === null || typeof options !== "object") {
+    return null;
+  }
+
+  for (option in options) {
+    if (option !== "backend" && options[option] !== undefined) {
+      return option;
+    }
+  }
+
+  return null;
+}
+
+function resolve(options) {
+  var kind = options && options.backend !== undefined ? options.backend : backend,
+    option = nativeOption(options);
+
+  if (!backends.hasOwnProperty(kind)) {
+    throw new TypeError("Unknown backend: " + kind);
+  }
+
+  // "auto" never picks a backend that would drop an option
+  if (kind === "auto") {
+    if (option !== null) {
+      return "native";
+    }
+
+    if (measured === null) {
+      measured = adapter.available ? measure() : "native";
+    }
+
+    kind = measured;
+  }
+
+  if (kind === "es" && !adapter.available) {
+    throw new Error("The built-in Proxy is not available");
+  }
+
+  if (kind === "es" && option !== null) {
+    throw new TypeError("The es backend does not support the " + option + " option");
+  }
+
+  return kind;
+}
+
+exports.create = function (handler, proto, options) {
+  if (resolve(options) === "es") {
+    if (handler === null || typeof handler !== "object") {
+      throw new TypeError("create requires more than 0 arguments");
+    }
+
+    return adapter.create(handler, proto);
+  }
+
+  return binding.create.apply(binding, arguments);
+};
+
+exports.createFunction = function (handler, callTrap, constructTrap, options) {
+  if (resolve(options) === "es") {
+    if (handler === null || typeof handler !== "object" || typeof callTrap !== "function") {
+      throw new TypeError("createFunction requires at least 2 arguments");
+    }
+
+    return adapter.createFunction(handler, callTrap,
+                                  typeof constructTrap === "function" ? constructTrap : undefined);
+  }
+
+  return binding.createFunction.apply(binding, arguments);
+};
+
+/*
+ *  Set the backend used by create and createFunction when no
+ *  backend option is passed: "native", "es" or "auto".
+ *  "auto" times both backends the first time it is used, by this
+ *  or by the backend option, and keeps the faster one from then on.
+ *  Returns the backend now in use.
+ */
+exports.setBackend = function (kind) {
+  var resolved = resolve({ backend: kind });
+
+  backend = kind;
+
+  return resolved;
+};
+
+exports.backend = function (obj) {
+  if (arguments.length === 0) {
+    return resolve({ backend: backend });
+  }
+
+  return adapter.isProxy(obj) ? "es" : binding.isProxy(obj) ? "native" : null;
+};
+
+exports.isProxy = function (obj) {
+  return adapter.isProxy(obj) || binding.isProxy(obj);
+};
+
+exports.isTrapping = function (obj) {
+  return adapter.isProxy(obj) ? adapter.isTrapping(obj) : binding.isTrapping(obj);
+};
+
+// the lock methods call the fix trap of an ES backed proxy through
+// the adapter, everything else answers them like a plain object
+["freeze", "seal", "preventExtensions"].forEach(function (kind) {
+  exports[kind] = function (obj) {
+    return adapter.isProxy(obj) ? adapter.lock(obj, kind) : binding[kind](obj);
+  };
+});
+
+["isFrozen", "isSealed", "isExtensible"].forEach(function (kind) {
+  exports[kind] = function (obj) {
+    return adapter.isProxy(obj) ? Object[kind](obj) : binding[kind](obj);
+  };
+});
+
+exports.getOwnPropertyDescriptor = function (obj, name) {
+  return adapter.isProxy(obj) ?
+      Object.getOwnPropertyDescriptor(obj, name) :
+      binding.getOwnPropertyDescriptor(obj, name);
+};
+
+exports.defineProperty = function (obj, name, pd) {
+  if (adapter.isProxy(obj)) {
+    Object.defineProperty(obj, name, pd);
+    return true;
+  }
+
+  return binding.defineProperty(obj, name, pd);
+};
+
+exports.defineProperties = function (obj, descriptors) {
+  if (adapter.isProxy(obj)) {
+    Object.defineProperties(obj, descriptors);
+    return true;
+  }
+
+  return binding.defineProperties(obj, descriptors);
+};
+
+exports.getMany = function (obj, names) {
+  var values;
+
+  if (!adapter.isProxy(obj)) {
+    return binding.getMany(obj, names);
+  }
+
+  values = adapter.getMany(obj, names);
+
+  return values !== undefined ? values : names.map(function (name) {
+    return obj[name];
+  });
+};
+
+exports.setMany = function (obj, entries) {
+  if (!adapter.isProxy(obj)) {
+    return binding.setMany(obj, entries);
+  }
+
+  if (adapter.setMany(obj, entries) === undefined) {
+    Object.getOwnPropertyNames(entries).forEach(function (name) {
+      obj[name] = entries[name];
+    });
+  }
+
+  return true;
+};
+
+if (process.env.NODE_PROXY_BACKEND) {
+  exports.setBackend(process.env.NODE_PROXY_BACKEND);
+}
@@ -0,0 +1,220 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#ifndef NODE_PROXY_ARRAY_VIEW_H // NOLINT
+#define NODE_PROXY_ARRAY_VIEW_H
+
+#include <stdint.h>
+#include <float.h>
+#include <math.h>
+#include <v8.h>
+#include <node_version.h>
+#include "nan.h"
+
+/**
+ *  Native access to the elements of the typed array behind
+ *  a proxy made by createArrayView, with the conversions
+ *  V8 applies when storing into each kind of typed array
+ *
+ */
+class ArrayView {
+  public:
+  enum Kind {
+    kNone = 0,
+    kInt8,
+    kUint8,
+    kUint8Clamped,
+    kInt16,
+    kUint16,
+    kInt32,
+    kUint32,
+    kFloat32,
+    kFloat64
+  };
+
+  static Kind KindOf(v8::Local<v8::Value> value) {
+#if NODE_MODULE_VERSION >= NODE_0_12_MODULE_VERSION
+    if (value->IsFloat64Array()) return kFloat64;
+    if (value->IsFloat32Array()) return kFloat32;
+    if (value->IsInt32Array()) return kInt32;
+    if (value->IsUint32Array()) return kUint32;
+    if (value->IsInt16Array()) return kInt16;
+    if (value->IsUint16Array()) return kUint16;
+    if (value->IsInt8Array()) return kInt8;
+    if (value->IsUint8Array()) return kUint8;
+    if (value->IsUint8ClampedArray()) return kUint8Clamped;
+#else
+    // typed arrays keep their elements as external array data
+    if (value->IsObject() &&
+        value->ToObject()->HasIndexedPropertiesInExternalArrayData()) {
+      switch (value->ToObject()->GetIndexedPropertiesExternalArrayDataType()) {
+        case v8::kExternalByteArray: return kInt8;
+        case v8::kExternalUnsignedByteArray: return kUint8;
+        case v8::kExternalPixelArray: return kUint8Clamped;
+        case v8::kExternalShortArray: return kInt16;
+        case v8::kExternalUnsignedShortArray: return kUint16;
+        case v8::kExternalIntArray: return kInt32;
+        case v8::kExternalUnsignedIntArray: return kUint32;
+        case v8::kExternalFloatArray: return kFloat32;
+        case v8::kExternalDoubleArray: return kFloat64;
+        default: break;
+      }
+    }
+#endif
+    return kNone;
+  }
+
+  static uint32_t Length(Kind kind, v8::Local<v8::Value> view) {
+    switch (kind) {
+      case kInt8: return Count<int8_t>(view);
+      case kUint8:
+      case kUint8Clamped: return Count<uint8_t>(view);
+      case kInt16: return Count<int16_t>(view);
+      case kUint16: return Count<uint16_t>(view);
+      case kInt32: return Count<int32_t>(view);
+      case kUint32: return Count<uint32_t>(view);
+      case kFloat32: return Count<float>(view);
+      case kFloat64: return Count<double>(view);
+      default: return 0;
+    }
+  }
+
+  // false when index is past the end of the view
+  static bool Get(Kind kind, v8::Local<v8::Value> view, uint32_t index, double *value) {
+    switch (kind) {
+      case kInt8: return Read<int8_t>(view, index, value);
+      case kUint8:
+      case kUint8Clamped: return Read<uint8_t>(view, index, value);
+      case kInt16: return Read<int16_t>(view, index, value);
+      case kUint16: return Read<uint16_t>(view, index, value);
+      case kInt32: return Read<int32_t>(view, index, value);
+      case kUint32: return Read<uint32_t>(view, index, value);
+      case kFloat32: return Read<float>(view, index, value);
+      case kFloat64: return Read<double>(view, index, value);
+      default: return false;
+    }
+  }
+
+  static bool Set(Kind kind, v8::Local<v8::Value> view, uint32_t index, double value) {
+    switch (kind) {
+      case kInt8: return Write<int8_t>(view, index, static_cast<int8_t>(Wrap(value)));
+      case kUint8: return Write<uint8_t>(view, index, static_cast<uint8_t>(Wrap(value)));
+      case kUint8Clamped: return Write<uint8_t>(view, index, Clamp(value));
+      case kInt16: return Write<int16_t>(view, index, static_cast<int16_t>(Wrap(value)));
+      case kUint16: return Write<uint16_t>(view, index, static_cast<uint16_t>(Wrap(value)));
+      case kInt32: return Write<int32_t>(view, index, static_cast<int32_t>(Wrap(value)));
+      case kUint32: return Write<uint32_t>(view, index, Wrap(value));
+      case kFloat32: return Write<float>(view, index, Narrow(value));
+      case kFloat64: return Write<double>(view, index, value);
+      default: return false;
+    }
+  }
+
+  private:
+  template <typename T>
+  static inline uint32_t Count(v8::Local<v8::Value> view) {
+    Nan::TypedArrayContents<T> contents(view);
+    return *contents == NULL ? 0 : static_cast<uint32_t>(contents.length());
+  }
+
+  template <typename T>
+  static inline bool Read(v8::Local<v8::Value> view, uint32_t index, double *value) {
+    Nan::TypedArrayContents<T> contents(view);
+
+    if (*contents == NULL || index >= contents.length()) {
+      return false;
+    }
+
+    *value = static_cast<double>((*contents)[index]);
+
+    return true;
+  }
+
+  template <typename T>
+  static inline bool Write(v8::Local<v8::Value> view, uint32_t index, T value) {
+    Nan::TypedArrayContents<T> contents(view);
+
+    if (*contents == NULL || index >= contents.length()) {
+      return false;
+    }
+
+    (*contents)[index] = value;
+
+    return true;
+  }
+
+  public:
+  // ToUint32, the narrower integer kinds keep its low bits
+  static inline uint32_t Wrap(double value) {
+    if (!(value == value) || value == INFINITY || value == -INFINITY) {
+      return 0;
+    }
+
+    double integer = fmod(value < 0 ? ceil(value) : floor(value), 4294967296.0);
+
+    if (integer < 0) {
+      integer += 4294967296.0;
+    }
+
+    return static_cast<uint32_t>(integer);
+  }
+
+  // ToUint8Clamp, ties round to even
+  static inline uint8_t Clamp(double value) {
+    if (!(value > 0)) {
+      return 0;
+    }
+
+    if (value >= 255) {
+      return 255;
+    }
+
+    return static_cast<uint8_t>(rint(value));
+  }
+
+  // ToFloat32, casting a double past the float range is undefined,
+  // so those round to the largest float or to Infinity explicitly
+  static inline float Narrow(double value) {
+    // FLT_MAX plus half a unit in the last place, the first
+    // double that rounds to Infinity
+    static const double kOverflow = 3.4028235677973366e38;
+
+    if (!(value == value) || fabs(value) <= FLT_MAX) {
+      return static_cast<float>(value);
+    }
+
+    if (fabs(value) < kOverflow) {
+      return value < 0 ? -FLT_MAX : FLT_MAX;
+    }
+
+    return value < 0 ? -INFINITY : INFINITY;
+  }
+};
+
+#endif // NODE_PROXY_ARRAY_VIEW_H // NOLINT
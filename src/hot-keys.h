@@ -0,0 +1,242 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#ifndef NODE_PROXY_HOT_KEYS_H // NOLINT
+#define NODE_PROXY_HOT_KEYS_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./property-name.h"
+
+/**
+ *  Approximate counts of the property names seen by a handler,
+ *  kept in a count-min sketch, along with the most frequent names.
+ *  The names are kept in a min-heap on count, reached through hash
+ *  buckets, so counting a tracked name only sifts its own entry.
+ *  Memory is fixed when it is created: width * depth counters,
+ *  plus at most size names of up to kMaxNameLength bytes.
+ */
+class HotKeySketch {
+  public:
+  static const size_t kMaxNameLength = 128;
+  static const uint32_t kNone = 0xffffffff;
+
+  // the largest width * depth and size, callers reject anything above them
+  static const uint32_t kMaxCounters = 1 << 24;
+  static const uint32_t kMaxSize = 1 << 16;
+
+  struct Entry {
+    uint32_t count;
+    uint32_t hash;
+    std::string name;
+    // the next entry in the same bucket
+    uint32_t chain;
+    // the index of the entry in heap_
+    uint32_t position;
+  };
+
+  HotKeySketch(uint32_t width, uint32_t depth, uint32_t size)
+      : width_(width), depth_(depth), size_(size),
+        counters_(static_cast<size_t>(width) * depth, 0),
+        entries_(size) {
+    uint32_t buckets = 1;
+
+    while (buckets < size_ * 2) {
+      buckets <<= 1;
+    }
+
+    buckets_.assign(buckets, static_cast<uint32_t>(kNone));
+    heap_.reserve(size);
+  }
+
+  void Add(const PropertyName &name) {
+    size_t length = name.length() < kMaxNameLength ? name.length() : kMaxNameLength;
+    uint32_t second = PropertyName::Hash(name.data(), length, 0x9e3779b9u) | 1;
+    uint32_t estimate = 0xffffffffu;
+
+    // double hashing gives each row its own index
+    for (uint32_t row = 0; row < depth_; ++row) {
+      uint32_t &counter = counters_[row * width_ +
+                                    (name.hash() + row * second) % width_];
+
+      if (counter < 0xffffffffu) {
+        ++counter;
+      }
+
+      estimate = std::min(estimate, counter);
+    }
+
+    Offer(name, length, estimate);
+  }
+
+  // the most frequent names, most frequent first
+  std::vector<Entry> Top(uint32_t k) const {
+    std::vector<Entry> top;
+
+    top.reserve(heap_.size());
+
+    for (size_t i = 0, l = heap_.size(); i < l; ++i) {
+      top.push_back(entries_[heap_[i]]);
+    }
+
+    std::sort(top.begin(), top.end(), MoreFrequent);
+
+    if (top.size() > k) {
+      top.resize(k);
+    }
+
+    return top;
+  }
+
+  void Clear() {
+    std::fill(counters_.begin(), counters_.end(), 0);
+    std::fill(buckets_.begin(), buckets_.end(), static_cast<uint32_t>(kNone));
+    heap_.clear();
+  }
+
+  private:
+  static bool MoreFrequent(const Entry &a, const Entry &b) {
+    return a.count > b.count;
+  }
+
+  inline uint32_t &Bucket(uint32_t hash) {
+    return buckets_[hash & (buckets_.size() - 1)];
+  }
+
+  void Offer(const PropertyName &name, size_t length, uint32_t estimate) {
+    uint32_t slot;
+
+    for (slot = Bucket(name.hash()); slot != kNone; slot = entries_[slot].chain) {
+      if (entries_[slot].hash == name.hash() &&
+          entries_[slot].name.compare(0, std::string::npos, name.data(), length) == 0) {
+        // estimates only grow, so the entry can only move down
+        entries_[slot].count = estimate;
+        SiftDown(entries_[slot].position);
+        return;
+      }
+    }
+
+    if (heap_.size() < size_) {
+      slot = static_cast<uint32_t>(heap_.size());
+      entries_[slot].position = slot;
+      heap_.push_back(slot);
+    } else if (size_ == 0 || entries_[heap_[0]].count >= estimate) {
+      return;
+    } else {
+      // replace the least frequent tracked name
+      slot = heap_[0];
+      Unchain(slot);
+    }
+
+    Entry &entry = entries_[slot];
+    uint32_t &bucket = Bucket(name.hash());
+
+    entry.count = estimate;
+    entry.hash = name.hash();
+    entry.name.assign(name.data(), length);
+    entry.chain = bucket;
+    bucket = slot;
+
+    SiftUp(entry.position);
+    SiftDown(entry.position);
+  }
+
+  void Unchain(uint32_t slot) {
+    uint32_t *link = &Bucket(entries_[slot].hash);
+
+    while (*link != slot) {
+      link = &entries_[*link].chain;
+    }
+
+    *link = entries_[slot].chain;
+  }
+
+  inline void Place(uint32_t position, uint32_t slot) {
+    heap_[position] = slot;
+    entries_[slot].position = position;
+  }
+
+  // min-heap on count, so the least frequent tracked name is at the front
+  void SiftUp(uint32_t position) {
+    uint32_t slot = heap_[position];
+
+    while (position > 0) {
+      uint32_t parent = (position - 1) / 2;
+
+      if (entries_[heap_[parent]].count <= entries_[slot].count) {
+        break;
+      }
+
+      Place(position, heap_[parent]);
+      position = parent;
+    }
+
+    Place(position, slot);
+  }
+
+  void SiftDown(uint32_t position) {
+    uint32_t slot = heap_[position];
+    uint32_t size = static_cast<uint32_t>(heap_.size());
+
+    for (;;) {
+      uint32_t child = position * 2 + 1;
+
+      if (child >= size) {
+        break;
+      }
+
+      if (child + 1 < size &&
+          entries_[heap_[child + 1]].count < entries_[heap_[child]].count) {
+        ++child;
+      }
+
+      if (entries_[slot].count <= entries_[heap_[child]].count) {
+        break;
+      }
+
+      Place(position, heap_[child]);
+      position = child;
+    }
+
+    Place(position, slot);
+  }
+
+  uint32_t width_;
+  uint32_t depth_;
+  uint32_t size_;
+  std::vector<uint32_t> counters_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> buckets_;
+  // slots of entries_, ordered as a min-heap on count
+  std::vector<uint32_t> heap_;
+};
+
+#endif // NODE_PROXY_HOT_KEYS_H // NOLINT
@@ -34,6 +34,113 @@
 
 Nan::Persistent<ObjectTemplate> NodeProxy::ObjectCreator;
 Nan::Persistent<ObjectTemplate> NodeProxy::FunctionCreator;
+ProxyIsolateData *NodeProxy::Isolates = NULL;
+
+// the names the locking functions are exported under, indexed by ProxyLock
+static const ProxyKey ProxyLockNames[kLockCount] = {
+  kKeyFreeze,
+  kKeySeal,
+  kKeyPreventExtensions,
+  kKeyIsFrozen,
+  kKeyIsSealed,
+  kKeyIsExtensible,
+  kKeyIsTrapping
+};
+Nan::Persistent<ObjectTemplate> HandlerRecord::RecordCreator;
+Nan::Persistent<ObjectTemplate> ProxyExtension::ExtensionCreator;
+Nan::Persistent<ObjectTemplate> StructRecord::StructCreator;
+Nan::Persistent<ObjectTemplate> NameRecord::NameCreator;
+uint32_t TrapScope::Enabled = 0;
+TraceEntry TrapScope::Trace[kTraceCapacity];
+uint64_t TrapScope::TraceCount = 0;
+uint32_t TrapScope::TraceIds = 0;
+
+#if NODE_PROXY_HAVE_SDT
+// non zero while a tracer is attached to the probes, @see probes.h
+unsigned short nodeproxy_trap__entry_semaphore  // NOLINT
+    __attribute__((unused)) __attribute__((section(".probes")));
+unsigned short nodeproxy_trap__exit_semaphore  // NOLINT
+    __attribute__((unused)) __attribute__((section(".probes")));
+#endif
+
+// the names stats are reported under, indexed by ProxyIntercept
+static const char *ProxyInterceptNames[kInterceptCount] = {
+  "get",
+  "set",
+  "query",
+  "delete",
+  "enumerate",
+  "call",
+  "construct"
+};
+
+// the names of the dispatch paths, indexed by ProxyIntercept and
+// by the value of GetPath, SetPath, QueryPath and EnumeratePath
+static const char *ProxyPathNames[kInterceptCount][kPathCount] = {
+  { "none", "get", "getPropertyDescriptor", "getOwnPropertyDescriptor", "getValue" },
+  { "none", "set", "getOwnPropertyDescriptor", "getPropertyDescriptor", "setValue" },
+  { "none", "hasOwn", "has", "descriptor", NULL },
+  { NULL, NULL, NULL, NULL, NULL },
+  { "none", "enumerate", "keys", "getPropertyNames", NULL },
+  { NULL, NULL, NULL, NULL, NULL },
+  { NULL, NULL, NULL, NULL, NULL }
+};
+
+// must stay in the same order as ProxyKey
+static const char *ProxyKeyNames[kKeyCount] = {
+  "get",
+  "set",
+  "has",
+  "hasOwn",
+  "delete",
+  "enumerate",
+  "keys",
+  "getPropertyNames",
+  "getPropertyDescriptor",
+  "getOwnPropertyDescriptor",
+  "defineProperty",
+  "fix",
+  "getValue",
+  "setValue",
+  "indexRange",
+  "getMany",
+  "setMany",
+  "value",
+  "writable",
+  "configurable",
+  "enumerable",
+  "length",
+  "next",
+  "done",
+  "size",
+  "trapping",
+  "extensible",
+  "sealed",
+  "frozen",
+  "freeze",
+  "seal",
+  "preventExtensions",
+  "isExtensible",
+  "isSealed",
+  "isTrapping",
+  "isFrozen",
+  "NodeProxy::hidden:",
+  "NodeProxy::record",
+  "NodeProxy::layout",
+  "named",
+  "indexed",
+  "nonMasking",
+  "ignore",
+  "materialize",
+  "forward",
+  "statics",
+  "cacheQueries",
+  "Object",
+  "create",
+  "maxEntries",
+  "ttlMs",
+  "NodeProxy::names"
+};
 
 /**
  *
@@ -54,285 +161,2884 @@ NodeProxy::~NodeProxy() {
 }
 
 /**
- *  Used for creating a shallow copy of an object
+ *  Build the internalized key table for the current isolate
+ *  Called once from NodeProxy::Init, so that the interceptors
+ *  never allocate or hash a key string on the access path
+ *
+ */
+void NodeProxy::InitKeys() {
+  Isolate *isolate = Isolate::GetCurrent();
+
+  for (ProxyIsolateData *data = Isolates; data != NULL; data = data->next) {
+    if (data->isolate == isolate) {
+      return;
+    }
+  }
+
+  ProxyIsolateData *data = new ProxyIsolateData();
+  data->isolate = isolate;
+
+  for (int i = 0; i < kKeyCount; ++i) {
+#if PROXY_NODE_VERSION_AT_LEAST(0, 12, 0)
+    data->keys[i].Set(isolate,
+        String::NewFromUtf8(isolate, ProxyKeyNames[i], String::kInternalizedString));
+#else
+    data->keys[i].Reset(String::NewSymbol(ProxyKeyNames[i]));
+#endif
+  }
+
+  data->next = Isolates;
+  Isolates = data;
+}
+
+/**
+ *  Retrieve one of the interned keys for the current isolate
  *
+ *  @param ProxyKey
+ *  @returns String
+ */
+NAN_INLINE Local<String> NodeProxy::Key(ProxyKey key) {
+  ProxyIsolateData *data = IsolateData();
+
+#if PROXY_NODE_VERSION_AT_LEAST(0, 12, 0)
+  return data->keys[key].Get(data->isolate);
+#else
+  return Nan::New(data->keys[key]);
+#endif
+}
+
+/**
+ *  Retrieve the key table and template cache of the current isolate
  *
- *  @param mixed
- *  @returns mixed
- *  @throws Error
+ *  @returns ProxyIsolateData
  */
-NAN_METHOD(NodeProxy::Clone) {
+NAN_INLINE ProxyIsolateData *NodeProxy::IsolateData() {
+  Isolate *isolate = Isolate::GetCurrent();
+  ProxyIsolateData *data = Isolates;
 
-  if (info.Length() < 1) {
-    Nan::ThrowError("clone requires at least one (1) argument.");
-    return;
+  while (data->isolate != isolate) {
+    data = data->next;
   }
 
-  if (info[0]->IsString()) {
-    info.GetReturnValue().Set(info[0]->ToObject()->Clone()->ToString());
-    return;
+  return data;
+}
 
-  } else if (info[0]->IsBoolean()) {
-    info.GetReturnValue().Set(info[0]->ToObject()->Clone()->ToBoolean());
-    return;
+/**
+ *  Build an ObjectTemplate that installs only
+ *  the interceptors required by a shape
+ *
+ *  @param uint32_t - ProxyShape flags
+ *  @returns ObjectTemplate
+ */
+Local<ObjectTemplate> NodeProxy::BuildTemplate(uint32_t shape) {
+  Nan::EscapableHandleScope scope;
 
-  } else if (info[0]->IsNumber()
-        || info[0]->IsNumberObject()
-        || info[0]->IsInt32()
-        || info[0]->IsUint32()) {
-    info.GetReturnValue().Set(Nan::New<v8::Number>(info[0]->NumberValue()));
-    return;
+  Local<ObjectTemplate> temp = Nan::New<ObjectTemplate>();
 
-  } else if (info[0]->IsArray()) {
-    info.GetReturnValue().Set(Local<Array>::Cast(info[0]->ToObject()->Clone()));
-    return;
+  if (shape & kShapeFunction) {
+    Nan::SetCallAsFunctionHandler(temp, NodeProxy::New);
+    temp->SetInternalFieldCount(kFunctionFieldCount);
+  } else {
+    temp->SetInternalFieldCount(kProxyFieldCount);
+  }
 
-  } else if (info[0]->IsDate()) {
-    info.GetReturnValue().Set(Local<Date>::Cast(info[0]->ToObject()->Clone()));
-    return;
+  // the getter is always installed, without it a proxy
+  // would expose whatever V8 finds on the bare instance
+  if (shape & kShapeNamed) {
+    Nan::PropertySetterCallback setter = NULL;
+    Nan::PropertyQueryCallback query = NULL;
+    Nan::PropertyDeleterCallback deleter = NULL;
+    Nan::PropertyEnumeratorCallback enumerator = NULL;
 
-  } else if (info[0]->IsFunction()) {
-    info.GetReturnValue().Set(Local<Function>::Cast(info[0])->Clone());
-    return;
+    if (shape & kShapeSet) {
+      setter = SetNamedProperty;
+    }
+    if (shape & kShapeQuery) {
+      query = QueryNamedPropertyInteger;
+    }
+    if (shape & kShapeDelete) {
+      deleter = DeleteNamedProperty;
+    }
+    if (shape & kShapeEnumerate) {
+      enumerator = EnumerateNamedProperties;
+    }
 
-  } else if (info[0]->IsNull()) {
-    info.GetReturnValue().SetNull();
-    return;
+#if PROXY_NODE_VERSION_AT_LEAST(4, 0, 0)
+    // every named interceptor is strings only, as the ones Nan
+    // registers are, and Nan cannot pass kNonMasking, so the
+    // interceptors are configured directly through the thunks
+    int flags = static_cast<int>(PropertyHandlerFlags::kOnlyInterceptStrings);
 
-  } else if (info[0]->IsUndefined()) {
-    info.GetReturnValue().SetUndefined();
-    return;
+    if (shape & kShapeNonMasking) {
+      flags |= static_cast<int>(PropertyHandlerFlags::kNonMasking);
+    }
 
-  } else if (info[0]->IsObject()) {
-    info.GetReturnValue().Set(info[0]->ToObject()->Clone());
-    return;
+    temp->SetHandler(NamedPropertyHandlerConfiguration(
+      NamedGetterThunk,
+      setter ? NamedSetterThunk : NULL,
+      query ? NamedQueryThunk : NULL,
+      deleter ? NamedDeleterThunk : NULL,
+      enumerator ? NamedEnumeratorThunk : NULL,
+      Nan::Undefined(),
+      static_cast<PropertyHandlerFlags>(flags)));
+#else
+    Nan::SetNamedPropertyHandler(
+      temp,
+      GetNamedProperty,
+      setter,
+      query,
+      deleter,
+      enumerator);
+#endif
   }
 
-  Nan::ThrowError("clone cannot determine the type of the argument.");
-  return;
+  // indices are enumerated natively, from the elements of an
+  // array view or the range returned by the indexRange trap
+  if (shape & kShapeIndexed) {
+    Nan::IndexSetterCallback setter = NULL;
+    Nan::IndexQueryCallback query = NULL;
+    Nan::IndexDeleterCallback deleter = NULL;
+    Nan::IndexEnumeratorCallback enumerator = NULL;
+
+    if (shape & kShapeSet) {
+      setter = SetIndexedProperty;
+    }
+    if (shape & kShapeQuery) {
+      query = QueryIndexedPropertyInteger;
+    }
+    if (shape & kShapeDelete) {
+      deleter = DeleteIndexedProperty;
+    }
+    if (shape & kShapeEnumerate) {
+      enumerator = EnumerateIndexedProperties;
+    }
+    // the elements of an array view are answered natively
+    // whatever traps the handler defines
+    if (shape & kShapeArrayView) {
+      setter = SetIndexedProperty;
+      query = QueryIndexedPropertyInteger;
+      deleter = DeleteIndexedProperty;
+      enumerator = EnumerateIndexedProperties;
+    }
+
+    Nan::SetIndexedPropertyHandler(
+      temp,
+      GetIndexedProperty,
+      setter,
+      query,
+      deleter,
+      enumerator);
+  }
+
+  return scope.Escape(temp);
 }
 
 /**
- *  Set or Retrieve the value of a hidden
- *  property on a given object
- *  Passing two arguments to this function
- *  returns the value of the hidden property
- *  While passing three arguments to this function
- *  results in the setting of the hidden property
- *  and returns a Boolean value indicating successful
- *  setting of value
+ *  Retrieve the cached ObjectTemplate for a shape,
+ *  building it the first time the shape is used
+ *
+ *  @param uint32_t - ProxyShape flags
+ *  @returns ObjectTemplate
+ */
+Local<ObjectTemplate> NodeProxy::Template(uint32_t shape) {
+  ProxyIsolateData *data = IsolateData();
+
+  if (data->templates[shape].IsEmpty()) {
+    data->templates[shape].Reset(BuildTemplate(shape));
+  }
+
+  return Nan::New(data->templates[shape]);
+}
+
+/**
+ *  Work out which interceptors a proxy needs from the
+ *  traps its handler defines and the creation options
+ *
+ *  * A handler with a fix trap gets every interceptor,
+ *  * because a locked proxy is served from its descriptors.
+ *  * Indices stay trapped unless indexed is false, the
+ *  * traps see them as names like any other property
+ *
+ *  @param HandlerRecord
+ *  @param ProxyOptions
+ *  @returns uint32_t - ProxyShape flags
+ */
+uint32_t NodeProxy::ShapeOf(HandlerRecord *record, const ProxyOptions &options) {
+  uint32_t shape = 0;
+
+  if (record->HasTrap(kTrapFix) || !options.target.IsEmpty()) {
+    shape = kShapeSet | kShapeQuery | kShapeDelete | kShapeEnumerate;
+  } else {
+    // with a getter, keep writes and queries trapped so that they
+    // never land on or are answered by the bare instance
+    if (record->get != kGetPathNone) {
+      shape |= kShapeSet | kShapeQuery;
+    }
+    if (record->set != kSetPathNone) {
+      shape |= kShapeSet;
+    }
+    if (record->query != kQueryPathNone) {
+      shape |= kShapeQuery;
+    }
+    if (record->HasTrap(kTrapDelete)) {
+      shape |= kShapeDelete;
+    }
+    if (record->enumerate != kEnumeratePathNone ||
+        record->HasTrap(kTrapIndexRange)) {
+      shape |= kShapeEnumerate;
+    }
+  }
+
+  if (options.named) {
+    shape |= kShapeNamed;
+  }
+  if (options.indexed) {
+    shape |= kShapeIndexed;
+  }
+  if (!options.view.IsEmpty()) {
+    shape |= kShapeIndexed | kShapeArrayView;
+  }
+  // the fields of a struct are written, queried and
+  // enumerated natively, whatever the handler traps
+  if (!options.layout.IsEmpty()) {
+    shape |= kShapeNamed | kShapeSet | kShapeQuery | kShapeDelete | kShapeEnumerate;
+  }
+#if PROXY_NODE_VERSION_AT_LEAST(4, 0, 0)
+  if (options.nonMasking) {
+    shape |= kShapeNonMasking;
+  }
+#endif
+
+  return shape;
+}
+
+/**
+ *  Read the optional options argument of create and createFunction
+ *
+ *  @param Object - optional
+ *  @param ProxyOptions - receives the options
+ *  @returns Boolean - false once an exception is pending
+ *  @throws RangeError
+ */
+bool NodeProxy::ReadOptions(Local<Value> value, ProxyOptions *options) {
+  options->named = true;
+  options->indexed = true;
+  options->nonMasking = false;
+  options->materialize = false;
+  options->maxEntries = 0;
+  options->ttl = 0;
+  options->queryEntries = 0;
+  options->byteOffset = 0;
+  options->trapsUnknown = true;
+
+  if (value.IsEmpty() || !value->IsObject()) {
+    return true;
+  }
+
+  Local<Object> obj = value->ToObject();
+  Local<Value> named = obj->Get(Key(kKeyNamed));
+  Local<Value> indexed = obj->Get(Key(kKeyIndexed));
+  Local<Value> nonMasking = obj->Get(Key(kKeyNonMasking));
+  Local<Value> materialize = obj->Get(Key(kKeyMaterialize));
+
+  if (!named->IsUndefined()) {
+    options->named = named->BooleanValue();
+  }
+  if (!indexed->IsUndefined()) {
+    options->indexed = indexed->BooleanValue();
+  }
+  if (!nonMasking->IsUndefined()) {
+    options->nonMasking = nonMasking->BooleanValue();
+  }
+  // materialized properties are left to V8 by Bypasses once
+  // the proxy is locked, until then every name is trapped
+  if (!materialize->IsUndefined() && materialize->BooleanValue()) {
+    options->materialize = true;
+  }
+
+  options->ignore = obj->Get(Key(kKeyIgnore));
+  options->statics = obj->Get(Key(kKeyStatics));
+
+  Local<Value> cacheQueries = obj->Get(Key(kKeyCacheQueries));
+
+  if (cacheQueries->IsUint32() && cacheQueries->Uint32Value() > 0) {
+    if (cacheQueries->Uint32Value() > ReadCache::kMaxCapacity) {
+      Nan::ThrowRangeError("cacheQueries allows at most 1048576 names.");
+      return false;
+    }
+    options->queryEntries = cacheQueries->Uint32Value();
+  } else if (cacheQueries->IsTrue()) {
+    options->queryEntries = 256;
+  }
+
+  return true;
+}
+
+/**
+ *  Attach the native state required by the options
+ *  to a newly created proxy
  *
  *  @param Object
- *  @param String name
- *  @param mixed value - optional
- *  @returns mixed
- *  @throws Error
+ *  @param ProxyOptions
+ *  @returns uint32_t - ProxyState flags for the options
  */
-NAN_METHOD(NodeProxy::Hidden) {
+uint32_t NodeProxy::Extend(Local<Object> proxy, const ProxyOptions &options) {
+  uint32_t state = 0;
 
-  if (info.Length() < 2) {
-    Nan::ThrowError("hidden requires at least two (2) arguments.");
-    return;
+  if (options.nonMasking) {
+    state |= kStateNonMasking;
+  }
+  if (options.materialize) {
+    state |= kStateMaterialize;
   }
 
-  Local<Object> obj = info[0]->ToObject();
+  bool ignoring = !options.ignore.IsEmpty() && options.ignore->IsArray();
+  // static properties are ignored by name, so that V8 finds
+  // them on the proxy while every other name stays trapped
+  bool statics = !options.statics.IsEmpty() && options.statics->IsObject();
 
-  if (info.Length() < 3) {
-    info.GetReturnValue().Set(obj->GetHiddenValue(
-          String::Concat(Nan::New<String>("NodeProxy::hidden:").ToLocalChecked(),
-                   Nan::To<v8::String>(info[1]).ToLocalChecked())));
-    return;
+  if (!ignoring && !statics && options.target.IsEmpty() && options.view.IsEmpty() &&
+      options.layout.IsEmpty() && options.maxEntries == 0 &&
+      options.queryEntries == 0) {
+    proxy->SetInternalField(kExtensionField, Nan::Undefined());
+    return state;
   }
 
-  info.GetReturnValue().Set(
-    Nan::New<Boolean>(
-        obj->SetHiddenValue(String::Concat(Nan::New<String>("NodeProxy::hidden:").ToLocalChecked(),
-                           Nan::To<v8::String>(info[1]).ToLocalChecked()),
-        info[2])));
+  Local<Object> obj = ProxyExtension::New();
+  ProxyExtension *ext = Nan::ObjectWrap::Unwrap<ProxyExtension>(obj);
+
+  if (!options.target.IsEmpty()) {
+    obj->SetInternalField(ProxyExtension::kTargetField, options.target);
+    state |= kStateForwarding;
+  }
+
+  if (options.maxEntries > 0) {
+    ext->StartCache(options.maxEntries, options.ttl);
+    state |= kStateCaching;
+  }
+
+  if (options.queryEntries > 0) {
+    ext->attributes = new AttributeCache(options.queryEntries);
+    state |= kStateCachingQueries;
+  }
+
+  if (!options.view.IsEmpty()) {
+    obj->SetInternalField(ProxyExtension::kViewField, options.view);
+    ext->elements = ArrayView::KindOf(options.view);
+    state |= kStateArrayView;
+  }
+
+  if (!options.layout.IsEmpty()) {
+    obj->SetInternalField(ProxyExtension::kViewField, options.bytes);
+    obj->SetInternalField(ProxyExtension::kLayoutField, options.layout);
+    ext->layout = &Nan::ObjectWrap::Unwrap<StructRecord>(options.layout)->layout;
+    ext->byteOffset = options.byteOffset;
+    ext->trapsUnknown = options.trapsUnknown;
+    state |= kStateStruct;
+  }
+
+  if (ignoring) {
+    Local<Array> names = Local<Array>::Cast(options.ignore);
+
+    for (uint32_t i = 0, l = names->Length(); i < l; ++i) {
+      Local<Value> name = names->Get(i);
+
+      if (name->IsString()) {
+        PropertyName key(name->ToString());
+        ext->ignore.Add(key.data(), key.length());
+      }
+    }
+  }
+
+  if (statics) {
+    Local<Object> names = NameRecord::For(options.statics->ToObject());
+
+    obj->SetInternalField(ProxyExtension::kStaticsField, names);
+    ext->statics = &Nan::ObjectWrap::Unwrap<NameRecord>(names)->names;
+  }
+
+  proxy->SetInternalField(kExtensionField, obj);
+
+  if (!ext->ignore.Empty() || (ext->statics != NULL && !ext->statics->Empty())) {
+    state |= kStateIgnoring;
+  }
+
+  return state;
 }
 
 /**
- *  Set the prototype of an object
+ *  Install the statics option as read only, non enumerable
+ *  own properties of a newly created proxy, so that V8 finds
+ *  them without entering the interceptors
  *
  *  @param Object
+ *  @param ProxyOptions
+ */
+void NodeProxy::DefineStatics(Local<Object> proxy, const ProxyOptions &options) {
+  if (options.statics.IsEmpty() || !options.statics->IsObject()) {
+    return;
+  }
+
+  Nan::HandleScope scope;
+
+  Local<Object> statics = options.statics->ToObject();
+  Local<Array> names = statics->GetOwnPropertyNames();
+
+  for (uint32_t i = 0, l = names->Length(); i < l; ++i) {
+    Local<Value> name = names->Get(i);
+
+    Nan::ForceSet(proxy, name, statics->Get(name),
+        static_cast<PropertyAttribute>(ReadOnly | DontEnum));
+  }
+}
+
+/**
+ *  Whether a named access should skip the handler and be
+ *  resolved by V8 as if the proxy did not intercept it
+ *
  *  @param Object
+ *  @param String
  *  @returns Boolean
- *  @throws Error
  */
-NAN_METHOD(NodeProxy::SetPrototype) {
+NAN_INLINE bool NodeProxy::Bypasses(Local<Object> proxy, Local<String> property) {
+  uint32_t state = GetState(proxy);
 
-  if (info.Length() < 2) {
-    Nan::ThrowError("setPrototype requires at least two (2) arguments.");
-    return;
+  if (!(state & (kStateIgnoring | kStateNonMasking | kStateMaterialize))) {
+    return false;
   }
-  info.GetReturnValue().Set(Nan::New<Boolean>(info[0]->ToObject()->SetPrototype(info[1])));
+
+  if ((state & kStateMaterialize) && !(state & kStateTrapping) &&
+      proxy->HasRealNamedProperty(property)) {
+    return true;
+  }
+
+  if (state & kStateIgnoring) {
+    ProxyExtension *ext = ProxyExtension::From(proxy);
+
+    if (ext != NULL) {
+      PropertyName name(property);
+
+      if (ext->ignore.Contains(name) ||
+          (ext->statics != NULL && ext->statics->Contains(name))) {
+        return true;
+      }
+    }
+  }
+
+#if !PROXY_NODE_VERSION_AT_LEAST(4, 0, 0)
+  // V8 only supports non-masking interceptors from node 4
+  if ((state & kStateNonMasking) &&
+      !proxy->GetRealNamedProperty(property).IsEmpty()) {
+    return true;
+  }
+#endif
+
+  return false;
 }
 
 /**
- *  Determine if an Object was created by Proxy
+ *  Whether an indexed access should be resolved by V8,
+ *  true for the elements of a materialized proxy
  *
  *  @param Object
+ *  @param uint32_t
  *  @returns Boolean
  */
-NAN_METHOD(NodeProxy::IsProxy) {
+NAN_INLINE bool NodeProxy::Bypasses(Local<Object> proxy, uint32_t index) {
+  uint32_t state = GetState(proxy);
 
-  if (info.Length() < 1) {
-    Nan::ThrowError("isProxy requires at least one (1) argument.");
-    return;
-  }
+  return (state & kStateMaterialize) && !(state & kStateTrapping) &&
+         proxy->HasRealIndexedProperty(index);
+}
 
-  Local<Object> obj = info[0]->ToObject();
+/**
+ *  The target of a forwarding proxy
+ *
+ *  @param Object
+ *  @returns Object, empty unless the proxy forwards
+ */
+NAN_INLINE Local<Object> NodeProxy::ForwardTarget(Local<Object> proxy) {
+  if (!(GetState(proxy) & kStateForwarding)) {
+    return Local<Object>();
+  }
 
-  if (obj->InternalFieldCount() > 0) {
-    Local<Value> temp = obj->GetInternalField(0);
+  ProxyExtension *ext = ProxyExtension::From(proxy);
 
-    info.GetReturnValue().Set(Nan::New<Boolean>(!temp.IsEmpty() && temp->IsObject()));
-    return;
+  if (ext == NULL) {
+    return Local<Object>();
   }
 
-  info.GetReturnValue().Set(Nan::False());
+  return ext->Target();
 }
 
 /**
- *  Create an object that has ProxyHandler intercepts attached and
- *  optionally implements the prototype of another object
+ *  Whether a trap of a forwarding proxy returned
+ *  Proxy.forward to hand the access to the target
  *
- *  * ProxyHandler intercepts override the property handlers for any
- *  * given prototype. So, the ProxyHandler will be invoked for access
- *  * to the prototype's properties as well
+ *  @param Object
+ *  @param mixed - the result of the trap, empty when it threw
+ *  @returns Boolean
+ */
+NAN_INLINE bool NodeProxy::Forwards(Local<Object> proxy, Local<Value> result) {
+  return (GetState(proxy) & kStateForwarding) && !result.IsEmpty() && result->IsObject() &&
+         result->StrictEquals(Nan::New(IsolateData()->forward));
+}
+
+/**
+ *  The extension holding the read-through cache of a proxy
+ *  made by createCached, or its cache of query results
  *
- *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
- *  @param Object - optional, the prototype object to implement
- *  @returns Object
- *  @throws Error, TypeError
+ *  @param Object
+ *  @param uint32_t - ProxyState flags of the caches looked for
+ *  @returns ProxyExtension, or NULL unless the proxy has one of them
  */
-NAN_METHOD(NodeProxy::Create) {
+NAN_INLINE ProxyExtension *NodeProxy::Caching(Local<Object> proxy, uint32_t caches) {
+  if (proxy->InternalFieldCount() < kProxyFieldCount ||
+      !(GetState(proxy) & caches)) {
+    return NULL;
+  }
 
-  Local<Object> proxyHandler;
+  return ProxyExtension::From(proxy);
+}
+
+/**
+ *  Store the result of a get trap in the cache of a proxy
+ *
+ *  @param ProxyExtension - @see NodeProxy::Caching, may be NULL
+ *  @param String|uint32_t
+ *  @param mixed - empty when the trap threw, and then not stored
+ *  @returns mixed - the value
+ */
+NAN_INLINE Local<Value> NodeProxy::Remember(ProxyExtension *caching,
+              Local<String> property, Local<Value> value) {
+  if (caching != NULL) {
+    caching->Remember(PropertyName(property), value);
+  }
+
+  return value;
+}
+
+NAN_INLINE Local<Value> NodeProxy::Remember(ProxyExtension *caching,
+              uint32_t index, Local<Value> value) {
+  if (caching != NULL) {
+    caching->Remember(PropertyName(index), value);
+  }
+
+  return value;
+}
+
+/**
+ *  Store the attributes a query trap reported in the cache
+ *  of a proxy, an empty handle is remembered as absent
+ *
+ *  @param ProxyExtension - @see NodeProxy::Caching, may be NULL
+ *  @param String|uint32_t
+ *  @param Integer - PropertyAttribute flags, or empty
+ *  @returns Integer - the attributes
+ */
+NAN_INLINE Local<Integer> NodeProxy::RememberQuery(ProxyExtension *caching,
+              Local<String> property, Local<Integer> attributes) {
+  if (caching != NULL) {
+    caching->attributes->Insert(PropertyName(property), attributes.IsEmpty() ?
+        AttributeCache::kAbsent : static_cast<int32_t>(attributes->Value()));
+  }
+
+  return attributes;
+}
+
+NAN_INLINE Local<Integer> NodeProxy::RememberQuery(ProxyExtension *caching,
+              uint32_t index, Local<Integer> attributes) {
+  if (caching != NULL) {
+    caching->attributes->Insert(PropertyName(index), attributes.IsEmpty() ?
+        AttributeCache::kAbsent : static_cast<int32_t>(attributes->Value()));
+  }
+
+  return attributes;
+}
+
+/**
+ *  Drop a property from the caches of a proxy, before
+ *  anything that may change it reaches the handler
+ *
+ *  @param Object
+ *  @param String|uint32_t
+ */
+NAN_INLINE void NodeProxy::Invalidate(Local<Object> proxy, Local<String> property) {
+  ProxyExtension *caching = Caching(proxy, kStateCaching | kStateCachingQueries);
+
+  if (caching != NULL) {
+    caching->Forget(PropertyName(property));
+  }
+}
+
+NAN_INLINE void NodeProxy::Invalidate(Local<Object> proxy, uint32_t index) {
+  ProxyExtension *caching = Caching(proxy, kStateCaching | kStateCachingQueries);
+
+  if (caching != NULL) {
+    caching->Forget(PropertyName(index));
+  }
+}
+
+/**
+ *  The extension holding the typed array of a proxy
+ *  made by createArrayView
+ *
+ *  @param Object
+ *  @returns ProxyExtension, or NULL unless the proxy is a view
+ */
+NAN_INLINE ProxyExtension *NodeProxy::Viewing(Local<Object> proxy) {
+  if (proxy->InternalFieldCount() < kProxyFieldCount ||
+      !(GetState(proxy) & kStateArrayView)) {
+    return NULL;
+  }
+
+  return ProxyExtension::From(proxy);
+}
+
+/**
+ *  The extension holding the fields of a proxy made by createStruct
+ *
+ *  @param Object
+ *  @returns ProxyExtension, or NULL unless the proxy is a struct
+ */
+NAN_INLINE ProxyExtension *NodeProxy::Structured(Local<Object> proxy) {
+  if (proxy->InternalFieldCount() < kProxyFieldCount ||
+      !(GetState(proxy) & kStateStruct)) {
+    return NULL;
+  }
+
+  return ProxyExtension::From(proxy);
+}
+
+/**
+ *  Call the indexRange trap of a handler, which returns the
+ *  [start, end) range of indices the proxy holds
+ *
+ *  @param Object
+ *  @param HandlerRecord
+ *  @param uint32_t - receives the first index
+ *  @param uint32_t - receives one past the last index
+ *  @returns Boolean - false unless the trap returned a valid range
+ *  @throws RangeError - if the range spans more than kMaxIndexRange
+ */
+bool NodeProxy::IndexRange(Local<Object> proxy, HandlerRecord *record,
+            uint32_t *start, uint32_t *end) {
+  if (record == NULL || !record->HasTrap(kTrapIndexRange) ||
+      !(GetState(proxy) & kStateTrapping)) {
+    return false;
+  }
+
+  Nan::HandleScope scope;
+
+  Local<Object> handler = proxy->GetInternalField(kHandlerField)->ToObject();
+  Local<Value> range = record->Trap(kTrapIndexRange)->Call(handler, 0, NULL);
+
+  if (range.IsEmpty() || !range->IsArray()) {
+    return false;
+  }
+
+  Local<Array> bounds = Local<Array>::Cast(range);
+
+  if (bounds->Length() < 2) {
+    return false;
+  }
+
+  Local<Value> first = bounds->Get(0);
+
+  if (first.IsEmpty()) {
+    return false;
+  }
+
+  Local<Value> last = bounds->Get(1);
+
+  if (last.IsEmpty() || !first->IsUint32() || !last->IsUint32() ||
+      first->Uint32Value() > last->Uint32Value()) {
+    return false;
+  }
+
+  if (last->Uint32Value() - first->Uint32Value() > kMaxIndexRange) {
+    Nan::ThrowRangeError("indexRange may span at most 2147483647 indices.");
+    return false;
+  }
+
+  *start = first->Uint32Value();
+  *end = last->Uint32Value();
+
+  return true;
+}
+
+/**
+ *  The length of an array-like proxy, answered without the get
+ *  trap: the element count of an array view, or the end of the
+ *  range the indexRange trap returns when length is read
+ *
+ *  @param Object
+ *  @param HandlerRecord
+ *  @param String - the name being read
+ *  @param Value - receives the length, left empty once the trap threw
+ *  @returns Boolean - false unless property is the length of an array-like proxy
+ */
+NAN_INLINE bool NodeProxy::ArrayLength(Local<Object> proxy, HandlerRecord *record,
+            Local<String> property, Local<Value> *length) {
+  ProxyExtension *view = Viewing(proxy);
+
+  if ((view == NULL && !record->HasTrap(kTrapIndexRange)) ||
+      !property->StrictEquals(Key(kKeyLength))) {
+    return false;
+  }
+
+  if (view != NULL) {
+    *length = Nan::New<Number>(view->ElementCount());
+    return true;
+  }
+
+  Nan::TryCatch tc;
+  uint32_t start;
+  uint32_t end;
+  bool ranged = IndexRange(proxy, record, &start, &end);
+
+  if (tc.HasCaught()) {
+    tc.ReThrow();
+    return true;
+  }
+
+  if (!ranged) {
+    return false;
+  }
+
+  *length = Nan::New<Number>(end);
+
+  return true;
+}
+
+/**
+ *  Read a field of a struct from its buffer
+ *
+ *  @param ProxyExtension
+ *  @param StructLayout::Field
+ *  @returns Number|String, undefined once the buffer is too short
+ */
+NAN_INLINE Local<Value> NodeProxy::ReadField(ProxyExtension *ext,
+            const StructLayout::Field &field) {
+  const uint8_t *data = ext->Struct();
+
+  if (data == NULL) {
+    return Nan::Undefined();
+  }
+
+  if (field.type == StructLayout::kUtf8) {
+    return Nan::New<String>(reinterpret_cast<const char *>(data + field.offset),
+        static_cast<int>(StructLayout::TextLength(field, data))).ToLocalChecked();
+  }
+
+  return Nan::New<Number>(StructLayout::Read(field, data));
+}
+
+/**
+ *  Write a field of a struct to its buffer
+ *
+ *  @param ProxyExtension
+ *  @param StructLayout::Field
+ *  @param Value - converted like a store into a typed array,
+ *                 or to a String for utf8 fields
+ */
+NAN_INLINE void NodeProxy::WriteField(ProxyExtension *ext,
+            const StructLayout::Field &field, Local<Value> value) {
+  uint8_t *data = ext->Struct();
+
+  if (data == NULL) {
+    return;
+  }
+
+  if (field.type == StructLayout::kUtf8) {
+    Nan::Utf8String text(value);
+    StructLayout::WriteText(field, data, *text, static_cast<size_t>(text.length()));
+    return;
+  }
+
+  StructLayout::Write(field, data, value->NumberValue());
+}
+
+/**
+ *  The names of a struct, its fields followed by the names
+ *  the enumeration trap of its handler returns, if any
+ *
+ *  @param ProxyExtension
+ *  @param Object
+ *  @returns Array - empty once the enumeration trap threw
+ */
+Local<Array> NodeProxy::StructNames(ProxyExtension *ext, Local<Object> proxy) {
+  Nan::EscapableHandleScope scope;
+
+  // the trap called for each EnumeratePath
+  static const ProxyTrap enumerators[] = {
+    kTrapCount, kTrapEnumerate, kTrapKeys, kTrapGetPropertyNames
+  };
+
+  const std::vector<StructLayout::Field> &fields = ext->layout->fields();
+  Local<Array> names = Nan::New<Array>(static_cast<int>(fields.size()));
+  uint32_t length = 0;
+
+  for (size_t i = 0; i < fields.size(); ++i) {
+    names->Set(length++, Nan::New<String>(fields[i].name.data(),
+        static_cast<int>(fields[i].name.length())).ToLocalChecked());
+  }
+
+  HandlerRecord *record = HandlerRecord::From(proxy);
+
+  if (!ext->trapsUnknown || record == NULL ||
+      record->enumerate == kEnumeratePathNone ||
+      !(GetState(proxy) & kStateTrapping)) {
+    return scope.Escape(names);
+  }
+
+  Local<Object> handler = proxy->GetInternalField(kHandlerField)->ToObject();
+  Local<Array> others;
+
+  if (!CollectNames(record->Trap(enumerators[record->enumerate])->Call(handler, 0, NULL),
+                    &others)) {
+    return Local<Array>();
+  }
+
+  if (!others.IsEmpty()) {
+    for (uint32_t i = 0, l = others->Length(); i < l; ++i) {
+      Local<Value> name = others->Get(i);
+
+      if (!name->IsString() || ext->layout->Find(PropertyName(name->ToString())) == NULL) {
+        names->Set(length++, name);
+      }
+    }
+  }
+
+  return scope.Escape(names);
+}
+
+/**
+ *  The names returned by an enumeration trap, either an Array or
+ *  an iterator, like a generator, whose next() yields names or
+ *  Arrays of names. An iterator may carry a size property, the
+ *  number of names it will yield, so that they are collected
+ *  into a single Array allocated up front, up to kMaxNameHint
+ *
+ *  @param Value - the result of the trap, empty when it threw
+ *  @param Array - receives the names, left empty unless result
+ *                 is an Array or an iterator
+ *  @returns Boolean - false once an exception is pending
+ */
+bool NodeProxy::CollectNames(Local<Value> result, Local<Array> *names) {
+  Nan::EscapableHandleScope scope;
+
+  if (result.IsEmpty()) {
+    return false;
+  }
+
+  if (!result->IsObject()) {
+    return true;
+  }
+
+  if (result->IsArray()) {
+    *names = scope.Escape(Local<Array>::Cast(result));
+    return true;
+  }
+
+  Nan::TryCatch tc;
+  Local<Object> source = result->ToObject();
+  Local<Value> next = source->Get(Key(kKeyNext));
+
+  if (tc.HasCaught()) {
+    tc.ReThrow();
+    return false;
+  }
+
+  if (!next->IsFunction()) {
+    return true;
+  }
+
+  Local<Value> size = source->Get(Key(kKeySize));
+
+  if (tc.HasCaught()) {
+    tc.ReThrow();
+    return false;
+  }
+
+  uint32_t hint = 0;
+
+  if (size->IsUint32()) {
+    hint = size->Uint32Value() < kMaxNameHint ? size->Uint32Value() : kMaxNameHint;
+  }
+
+  Local<Array> list = Nan::New<Array>(static_cast<int>(hint));
+  Local<Function> step = Local<Function>::Cast(next);
+  uint32_t length = 0;
+
+  for (;;) {
+    Nan::HandleScope item_scope;
+
+    Local<Value> item = step->Call(source, 0, NULL);
+
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return false;
+    }
+
+    // a malformed result ends the iteration
+    if (item.IsEmpty() || !item->IsObject()) {
+      break;
+    }
+
+    Local<Object> entry = item->ToObject();
+    Local<Value> done = entry->Get(Key(kKeyDone));
+
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return false;
+    }
+
+    if (done->BooleanValue()) {
+      break;
+    }
+
+    Local<Value> value = entry->Get(Key(kKeyValue));
+
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return false;
+    }
+
+    if (value->IsArray()) {
+      Local<Array> chunk = Local<Array>::Cast(value);
+
+      for (uint32_t i = 0, l = chunk->Length(); i < l; ++i) {
+        Local<Value> name = chunk->Get(i);
+
+        if (tc.HasCaught()) {
+          tc.ReThrow();
+          return false;
+        }
+
+        list->Set(length++, name);
+      }
+    } else {
+      list->Set(length++, value);
+    }
+  }
+
+  // drop the holes left by a size hint that was too large
+  if (length < hint) {
+    list->Set(Key(kKeyLength), Nan::New<Number>(length));
+  }
+
+  *names = scope.Escape(list);
+
+  return true;
+}
+
+/**
+ *  Turn the property descriptors returned by fix into real
+ *  properties of the proxy, so that V8 can serve them
+ *  without calling the interceptors
+ *
+ *  * Accessors can only be defined from node 0.12, before that
+ *  * they keep being served from the descriptor map
+ *
+ *  @param Object
+ *  @param Object - the result of the fix trap
+ *  @param uint32_t - ProxyState flags after the lock
+ */
+void NodeProxy::Materialize(Local<Object> proxy, Local<Object> pieces, uint32_t state) {
+  Nan::HandleScope scope;
+
+  Local<Array> names = pieces->GetOwnPropertyNames();
+
+  for (uint32_t i = 0, l = names->Length(); i < l; ++i) {
+    Local<Value> name = names->Get(i);
+    Local<Value> pd = pieces->Get(name);
+
+    if (!pd->IsObject()) {
+      continue;
+    }
+
+    Local<Object> desc = pd->ToObject();
+    PropertyAttribute attribs = MaterializedAttributes(desc, state);
+    Local<Value> get = desc->Get(Key(kKeyGet));
+    Local<Value> set = desc->Get(Key(kKeySet));
+
+    if (get->IsFunction() || set->IsFunction()) {
+#if PROXY_NODE_VERSION_AT_LEAST(0, 12, 0)
+      proxy->SetAccessorProperty(name->ToString(),
+          get->IsFunction() ? Local<Function>::Cast(get) : Local<Function>(),
+          set->IsFunction() ? Local<Function>::Cast(set) : Local<Function>(),
+          static_cast<PropertyAttribute>(attribs & ~ReadOnly));
+#endif
+      continue;
+    }
+
+    Nan::ForceSet(proxy, name, desc->Get(Key(kKeyValue)), attribs);
+  }
+}
+
+/**
+ *  A plain object holding the property descriptors returned by
+ *  fix, with the prototype of the proxy and locked the same way
+ *
+ *  * Unlike the proxy, it has no interceptors at all, so its
+ *  * reads take V8's inline caches like any other object
+ *
+ *  @param Object
+ *  @param Object - the result of the fix trap
+ *  @param ProxyLock - freeze, seal or preventExtensions
+ *  @returns Object, empty once an exception is pending
+ */
+Local<Value> NodeProxy::PlainCopy(Local<Object> proxy, Local<Object> pieces, ProxyLock lock) {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> global = Nan::GetCurrentContext()->Global();
+  Local<Object> object = global->Get(Key(kKeyObject))->ToObject();
+  Local<Value> argv[2] = {proxy->GetPrototype(), pieces};
+  Local<Value> plain = Local<Function>::Cast(object->Get(Key(kKeyCreate)))->Call(object, 2, argv);
+
+  if (plain.IsEmpty()) {
+    return Local<Value>();
+  }
+
+  Local<Value> locked = Local<Function>::Cast(
+      object->Get(Key(ProxyLockNames[lock])))->Call(object, 1, &plain);
+
+  if (locked.IsEmpty()) {
+    return Local<Value>();
+  }
+
+  return scope.Escape(plain);
+}
+
+/**
+ *  The attributes of a materialized property, restricted
+ *  further by the lock that caused the materialization
+ *
+ *  @param Object - property descriptor
+ *  @param uint32_t - ProxyState flags after the lock
+ *  @returns PropertyAttribute
+ */
+PropertyAttribute NodeProxy::MaterializedAttributes(Local<Object> pd, uint32_t state) {
+  int attribs = None;
+
+  if (state & kStateSealed) {
+    attribs |= DontDelete;
+  }
+  if (state & kStateFrozen) {
+    attribs |= ReadOnly;
+  }
+
+  Local<Value> configurable = pd->Get(Key(kKeyConfigurable));
+  Local<Value> enumerable = pd->Get(Key(kKeyEnumerable));
+  Local<Value> writable = pd->Get(Key(kKeyWritable));
+
+  if (!configurable.IsEmpty() && configurable->IsBoolean() && !configurable->BooleanValue()) {
+    attribs |= DontDelete;
+  }
+  if (!enumerable.IsEmpty() && enumerable->IsBoolean() && !enumerable->BooleanValue()) {
+    attribs |= DontEnum;
+  }
+  if (!writable.IsEmpty() && writable->IsBoolean() && !writable->BooleanValue()) {
+    attribs |= ReadOnly;
+  }
+
+  return static_cast<PropertyAttribute>(attribs);
+}
+
+#if PROXY_NODE_VERSION_AT_LEAST(4, 0, 0)
+/**
+ *  Adapt the V8 callbacks of the named handler to the
+ *  Nan interceptors, strings only so the casts are safe
+ *
+ */
+void NodeProxy::NamedGetterThunk(Local<Name> property,
+              const PropertyCallbackInfo<Value> &info) {
+  GetNamedProperty(property.As<String>(),
+        Nan::PropertyCallbackInfo<Value>(info, Nan::Undefined()));
+}
+
+void NodeProxy::NamedSetterThunk(Local<Name> property, Local<Value> value,
+              const PropertyCallbackInfo<Value> &info) {
+  SetNamedProperty(property.As<String>(), value,
+        Nan::PropertyCallbackInfo<Value>(info, Nan::Undefined()));
+}
+
+void NodeProxy::NamedQueryThunk(Local<Name> property,
+              const PropertyCallbackInfo<Integer> &info) {
+  QueryNamedPropertyInteger(property.As<String>(),
+        Nan::PropertyCallbackInfo<Integer>(info, Nan::Undefined()));
+}
+
+void NodeProxy::NamedDeleterThunk(Local<Name> property,
+              const PropertyCallbackInfo<Boolean> &info) {
+  DeleteNamedProperty(property.As<String>(),
+        Nan::PropertyCallbackInfo<Boolean>(info, Nan::Undefined()));
+}
+
+void NodeProxy::NamedEnumeratorThunk(const PropertyCallbackInfo<Array> &info) {
+  EnumerateNamedProperties(
+        Nan::PropertyCallbackInfo<Array>(info, Nan::Undefined()));
+}
+#endif
+
+/**
+ *  Create the record of traps for a ProxyHandler
+ *
+ *  @param ProxyHandler
+ *  @returns Object - wrapping the HandlerRecord
+ */
+Local<Object> HandlerRecord::New(Local<Object> handler) {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> obj = Nan::New<ObjectTemplate>(RecordCreator)->NewInstance();
+  HandlerRecord *record = new HandlerRecord();
+
+  record->Wrap(obj);
+  record->Resolve(handler);
+
+  return scope.Escape(obj);
+}
+
+/**
+ *  Find the record of traps shared by every proxy created
+ *  from a ProxyHandler, creating it on first use
+ *
+ *  * Only the first proxy created from a handler stores anything
+ *  * on it, a single hidden reference to the record, so a single
+ *  * handler can back any number of proxies
+ *
+ *  @param ProxyHandler
+ *  @returns Object - wrapping the HandlerRecord
+ */
+Local<Object> HandlerRecord::For(Local<Object> handler) {
+  Nan::EscapableHandleScope scope;
+
+  Local<String> key = NodeProxy::Key(kKeyRecord);
+  Local<Value> cached = handler->GetHiddenValue(key);
+
+  if (!cached.IsEmpty() && cached->IsObject()) {
+    return scope.Escape(cached->ToObject());
+  }
+
+  Local<Object> record = New(handler);
+  handler->SetHiddenValue(key, record);
+
+  return scope.Escape(record);
+}
+
+/**
+ *  The record of a proxy whose handler answers a batch of
+ *  accesses with a single call to trap
+ *
+ *  * Struct fields and array view elements are served natively,
+ *  * so those proxies never hand a batch to their handler
+ *
+ *  @param Object
+ *  @param ProxyTrap - kTrapGetMany or kTrapSetMany
+ *  @returns HandlerRecord, or NULL to access one name at a time
+ */
+HandlerRecord *NodeProxy::BulkRecord(Local<Object> obj, ProxyTrap trap) {
+  HandlerRecord *record = HandlerRecord::From(obj);
+
+  if (record == NULL || !record->HasTrap(trap)) {
+    return NULL;
+  }
+
+  uint32_t state = GetState(obj);
+
+  if (!(state & kStateTrapping) || (state & (kStateStruct | kStateArrayView))) {
+    return NULL;
+  }
+
+  return record;
+}
+
+/**
+ *  Compile the schema of createStruct, on first use only,
+ *  so the schema should not change once structs are made from it
+ *
+ *  @param Object - field names to "<type>@<offset>" specs
+ *  @returns Object - wrapping the StructRecord, empty after throwing
+ *  @throws Error, TypeError
+ */
+Local<Object> StructRecord::For(Local<Object> schema) {
+  Nan::EscapableHandleScope scope;
+
+  Local<String> key = NodeProxy::Key(kKeyLayout);
+  Local<Value> cached = schema->GetHiddenValue(key);
+
+  if (!cached.IsEmpty() && cached->IsObject()) {
+    return scope.Escape(cached->ToObject());
+  }
+
+  Local<Object> obj = Nan::New<ObjectTemplate>(StructCreator)->NewInstance();
+  StructRecord *record = new StructRecord();
+
+  record->Wrap(obj);
+  obj->SetInternalField(kHandlerField, Nan::New<Object>());
+
+  Local<Array> names = schema->GetOwnPropertyNames();
+
+  for (uint32_t i = 0, l = names->Length(); i < l; ++i) {
+    Local<Value> name = names->Get(i);
+    Local<Value> spec = schema->Get(name);
+    Nan::Utf8String field(name);
+    Nan::Utf8String type(spec);
+
+    if (!spec->IsString() ||
+        !record->layout.Add(*field, static_cast<size_t>(field.length()),
+                            std::string(*type, type.length()))) {
+      Nan::ThrowTypeError("createStruct requires every field of the schema "
+                          "to be a String like \"u32@8\".");
+      return Local<Object>();
+    }
+  }
+
+  if (!record->layout.Seal()) {
+    Nan::ThrowError("createStruct could not build a field table for the schema.");
+    return Local<Object>();
+  }
+
+  schema->SetHiddenValue(key, obj);
+
+  return scope.Escape(obj);
+}
+
+/**
+ *  Retrieve the compiled names of a statics object,
+ *  compiling and caching them on first use
+ *
+ *  @param Object - the statics option
+ *  @returns Object - wrapping the NameRecord
+ */
+Local<Object> NameRecord::For(Local<Object> statics) {
+  Nan::EscapableHandleScope scope;
+
+  Local<String> key = NodeProxy::Key(kKeyNames);
+  Local<Value> cached = statics->GetHiddenValue(key);
+
+  if (!cached.IsEmpty() && cached->IsObject()) {
+    return scope.Escape(cached->ToObject());
+  }
+
+  Local<Object> obj = Nan::New<ObjectTemplate>(NameCreator)->NewInstance();
+  NameRecord *record = new NameRecord();
+
+  record->Wrap(obj);
+
+  Local<Array> names = statics->GetOwnPropertyNames();
+
+  for (uint32_t i = 0, l = names->Length(); i < l; ++i) {
+    PropertyName name(names->Get(i)->ToString());
+    record->names.Add(name.data(), name.length());
+  }
+
+  statics->SetHiddenValue(key, obj);
+
+  return scope.Escape(obj);
+}
+
+/**
+ *  Start counting an interceptor call against the
+ *  record of the proxy, allocating its stats on first use
+ *
+ *  @param Object
+ *  @param ProxyIntercept
+ */
+void TrapScope::Begin(Local<Object> proxy, ProxyIntercept intercept,
+                      Local<String> property, uint32_t index) {
+  active_ = true;
+  tracing_ = false;
+  stats_ = NULL;
+  intercept_ = intercept;
+  record_ = HandlerRecord::From(proxy);
+
+#if NODE_PROXY_HAVE_SDT
+  if (PROXY_TRAP_ENTRY_ENABLED()) {
+    if (!property.IsEmpty()) {
+      PropertyName name(property);
+      PROXY_TRAP_ENTRY(intercept, name.data(), name.length(), record_);
+    } else {
+      char name[16];
+      int length = index == kNoIndex ? 0 :
+                   snprintf(name, sizeof(name), "%u", index);
+      PROXY_TRAP_ENTRY(intercept, name, length, record_);
+    }
+  }
+#endif
+
+  // the entry is claimed and filled by End, so that the
+  // calls nested in this one cannot overwrite it
+  if (Enabled & kTrace) {
+    tracing_ = true;
+    traceId_ = 0;
+    index_ = index;
+    property_ = property;
+
+    if (proxy->InternalFieldCount() >= kProxyFieldCount) {
+      uint32_t state = NodeProxy::GetState(proxy);
+
+      traceId_ = state >> kStateTraceShift;
+
+      if (traceId_ == 0) {
+        traceId_ = TraceIds = TraceIds % kMaxTraceId + 1;
+        NodeProxy::SetState(proxy, state | (traceId_ << kStateTraceShift));
+      }
+    }
+  }
+
+  HandlerRecord *record = record_;
+
+  if (!(Enabled & kStats) || record == NULL) {
+    start_ = uv_hrtime();
+    return;
+  }
+
+  if (record->stats == NULL) {
+    record->stats = new TrapStats();
+  }
+
+  int path = 0;
+
+  switch (intercept) {
+    case kInterceptGet:
+      path = record->get;
+      break;
+
+    case kInterceptSet:
+      path = record->set;
+      break;
+
+    case kInterceptQuery:
+      path = record->query;
+      break;
+
+    case kInterceptEnumerate:
+      path = record->enumerate;
+      break;
+
+    default:
+      break;
+  }
+
+  stats_ = record->stats;
+
+  ++stats_->calls[intercept];
+  ++stats_->paths[intercept][path];
+
+  start_ = uv_hrtime();
+}
+
+/**
+ *  Add the latency of the interceptor call to its histogram
+ *  and record the call in the trace ring buffer
+ *
+ */
+void TrapScope::End() {
+  uint64_t elapsed = uv_hrtime() - start_;
+  int bucket = 0;
+
+  if (PROXY_TRAP_EXIT_ENABLED()) {
+    PROXY_TRAP_EXIT(intercept_, record_);
+  }
+
+  if (tracing_) {
+    TraceEntry *entry = &Trace[TraceCount++ % kTraceCapacity];
+
+    entry->start = start_;
+    entry->duration = elapsed;
+    entry->proxy = traceId_;
+    entry->intercept = intercept_;
+    entry->index = index_;
+    entry->nameLength = property_.IsEmpty() ? 0 :
+        property_->WriteUtf8(entry->name, kTraceNameLength, NULL,
+                             String::NO_NULL_TERMINATION);
+  }
+
+  if (stats_ == NULL) {
+    return;
+  }
+
+  while ((elapsed >>= 1) != 0 && bucket < kLatencyBucketCount - 1) {
+    ++bucket;
+  }
+
+  ++stats_->latency[intercept_][bucket];
+}
+
+/**
+ *  Append a string to JSON output as a quoted JSON string
+ *
+ *  @param std::string - output
+ *  @param const char * - UTF-8
+ *  @param int - length in bytes
+ */
+static void AppendJSONString(std::string *out, const char *data, int length) {
+  static const char hex[] = "0123456789abcdef";
+
+  out->push_back('"');
+
+  for (int i = 0; i < length; ++i) {
+    unsigned char ch = static_cast<unsigned char>(data[i]);
+
+    if (ch == '"' || ch == '\\') {
+      out->push_back('\\');
+      out->push_back(ch);
+    } else if (ch < 0x20) {
+      out->append("\\u00");
+      out->push_back(hex[ch >> 4]);
+      out->push_back(hex[ch & 0xf]);
+    } else {
+      out->push_back(ch);
+    }
+  }
+
+  out->push_back('"');
+}
+
+/**
+ *  Create the native state of a single proxy
+ *
+ *  @returns Object - wrapping the ProxyExtension
+ */
+Local<Object> ProxyExtension::New() {
+  Nan::EscapableHandleScope scope;
+
+  Local<Object> obj = Nan::New<ObjectTemplate>(ExtensionCreator)->NewInstance();
+  ProxyExtension *ext = new ProxyExtension();
+
+  ext->Wrap(obj);
+  obj->SetInternalField(ProxyExtension::kTargetField, Nan::Undefined());
+  obj->SetInternalField(ProxyExtension::kCacheField, Nan::Undefined());
+  obj->SetInternalField(ProxyExtension::kViewField, Nan::Undefined());
+  obj->SetInternalField(ProxyExtension::kLayoutField, Nan::Undefined());
+
+  return scope.Escape(obj);
+}
+
+/**
+ *  Retrieve the ProxyExtension of an object created by Proxy
+ *
+ *  @param Object
+ *  @returns ProxyExtension, or NULL
+ */
+NAN_INLINE ProxyExtension *ProxyExtension::From(Local<Object> proxy) {
+  if (proxy->InternalFieldCount() < kProxyFieldCount) {
+    return NULL;
+  }
+
+  Local<Value> obj = proxy->GetInternalField(kExtensionField);
+
+  if (obj.IsEmpty() || !obj->IsObject()) {
+    return NULL;
+  }
+
+  return Nan::ObjectWrap::Unwrap<ProxyExtension>(obj->ToObject());
+}
+
+/**
+ *  Give a proxy its read-through cache, the values live
+ *  in an Array in kCacheField so that the GC sees them
+ *
+ *  @param uint32_t - the number of entries kept
+ *  @param uint64_t - nanoseconds an entry is served for, 0 for ever
+ */
+void ProxyExtension::StartCache(uint32_t maxEntries, uint64_t ttl) {
+  delete cache;
+  cache = new ReadCache(maxEntries, ttl);
+  handle()->SetInternalField(kCacheField, Nan::New<Array>(maxEntries));
+}
+
+/**
+ *  Look up a get result in the cache
+ *
+ *  @param PropertyName
+ *  @param mixed - receives the cached value
+ *  @returns Boolean - whether the cache held the name
+ */
+bool ProxyExtension::Recall(const PropertyName &name, Local<Value> *value) {
+  uint32_t slot = cache->Find(name, uv_hrtime());
+
+  if (slot == ReadCache::kNone) {
+    return false;
+  }
+
+  *value = CachedValues()->Get(slot);
+
+  return true;
+}
+
+void ProxyExtension::Remember(const PropertyName &name, Local<Value> value) {
+  // a trap that threw has nothing to remember
+  if (value.IsEmpty()) {
+    return;
+  }
+
+  CachedValues()->Set(cache->Insert(name, uv_hrtime()), value);
+}
+
+void ProxyExtension::Forget(const PropertyName &name) {
+  if (attributes != NULL) {
+    attributes->Remove(name);
+  }
+
+  if (cache == NULL) {
+    return;
+  }
+
+  uint32_t slot = cache->Remove(name);
+
+  if (slot != ReadCache::kNone) {
+    CachedValues()->Set(slot, Nan::Undefined());
+  }
+}
+
+void ProxyExtension::ForgetAll() {
+  if (attributes != NULL) {
+    attributes->Clear();
+  }
+
+  if (cache != NULL) {
+    cache->Clear();
+    handle()->SetInternalField(kCacheField, Nan::New<Array>(cache->capacity()));
+  }
+}
+
+/**
+ *  Retrieve the HandlerRecord of an object created by Proxy
+ *
+ *  @param Object
+ *  @returns HandlerRecord, or NULL
+ */
+NAN_INLINE HandlerRecord *HandlerRecord::From(Local<Object> proxy) {
+  if (proxy->InternalFieldCount() < kProxyFieldCount) {
+    return NULL;
+  }
+
+  Local<Value> obj = proxy->GetInternalField(kRecordField);
+
+  if (obj.IsEmpty() || !obj->IsObject()) {
+    return NULL;
+  }
+
+  return Nan::ObjectWrap::Unwrap<HandlerRecord>(obj->ToObject());
+}
+
+/**
+ *  Look up every trap on the handler and decide which
+ *  one answers each kind of access
+ *
+ *  @param ProxyHandler
+ */
+void HandlerRecord::Resolve(Local<Object> handler) {
+  Local<Object> self = handle();
+
+  traps = 0;
+
+  for (int i = 0; i < kTrapCount; ++i) {
+    Local<Value> trap = handler->Get(NodeProxy::Key(static_cast<ProxyKey>(i)));
+
+    if (trap->IsFunction()) {
+      traps |= 1 << i;
+      self->SetInternalField(i + 1, trap);
+    } else {
+      self->SetInternalField(i + 1, Nan::Undefined());
+    }
+  }
+
+  get = HasTrap(kTrapGet) ? kGetPathGet :
+        HasTrap(kTrapGetValue) ? kGetPathValue :
+        HasTrap(kTrapGetPropertyDescriptor) ? kGetPathPropertyDescriptor :
+        HasTrap(kTrapGetOwnPropertyDescriptor) ? kGetPathOwnPropertyDescriptor :
+        kGetPathNone;
+
+  set = HasTrap(kTrapSet) ? kSetPathSet :
+        HasTrap(kTrapSetValue) ? kSetPathValue :
+        HasTrap(kTrapGetOwnPropertyDescriptor) ? kSetPathOwnPropertyDescriptor :
+        HasTrap(kTrapGetPropertyDescriptor) ? kSetPathPropertyDescriptor :
+        kSetPathNone;
+
+  query = HasTrap(kTrapHasOwn) ? kQueryPathHasOwn :
+          HasTrap(kTrapHas) ? kQueryPathHas :
+          (HasTrap(kTrapGetOwnPropertyDescriptor) ||
+           HasTrap(kTrapGetPropertyDescriptor)) ? kQueryPathDescriptor :
+          kQueryPathNone;
+
+  enumerate = HasTrap(kTrapEnumerate) ? kEnumeratePathEnumerate :
+              HasTrap(kTrapKeys) ? kEnumeratePathKeys :
+              HasTrap(kTrapGetPropertyNames) ? kEnumeratePathPropertyNames :
+              kEnumeratePathNone;
+}
+
+/**
+ *  Read the packed lock state of an object created by Proxy
+ *
+ *  @param Object
+ *  @returns uint32_t - ProxyState flags
+ */
+NAN_INLINE uint32_t NodeProxy::GetState(Local<Object> proxy) {
+  return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(
+        Nan::GetInternalFieldPointer(proxy, kStateField)));
+}
+
+/**
+ *  Store the packed lock state of an object created by Proxy
+ *  The flags are kept as an aligned pointer, so
+ *  bit 0 is never used, @see ProxyState
+ *
+ *  @param Object
+ *  @param uint32_t - ProxyState flags
+ */
+NAN_INLINE void NodeProxy::SetState(Local<Object> proxy, uint32_t state) {
+  Nan::SetInternalFieldPointer(proxy, kStateField,
+        reinterpret_cast<void*>(static_cast<uintptr_t>(state)));
+}
+
+/**
+ *  The state an object ends up in after one of the locking functions
+ *
+ *  @param ProxyLock
+ *  @param uint32_t - ProxyState flags
+ *  @returns uint32_t - ProxyState flags
+ */
+NAN_INLINE uint32_t NodeProxy::LockState(ProxyLock lock, uint32_t state) {
+  switch (lock) {
+    case kLockFreeze:
+      return (state | kStateFrozen | kStateSealed) & ~kStateExtensible;
+
+    case kLockSeal:
+      return (state | kStateSealed) & ~kStateExtensible;
+
+    case kLockPreventExtensions:
+      return state & ~kStateExtensible;
+
+    default:
+      return state;
+  }
+}
+
+/**
+ *  Used for creating a shallow copy of an object
+ *
+ *
+ *  @param mixed
+ *  @returns mixed
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::Clone) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("clone requires at least one (1) argument.");
+    return;
+  }
+
+  if (info[0]->IsString()) {
+    info.GetReturnValue().Set(info[0]->ToObject()->Clone()->ToString());
+    return;
+
+  } else if (info[0]->IsBoolean()) {
+    info.GetReturnValue().Set(info[0]->ToObject()->Clone()->ToBoolean());
+    return;
+
+  } else if (info[0]->IsNumber()
+        || info[0]->IsNumberObject()
+        || info[0]->IsInt32()
+        || info[0]->IsUint32()) {
+    info.GetReturnValue().Set(Nan::New<v8::Number>(info[0]->NumberValue()));
+    return;
+
+  } else if (info[0]->IsArray()) {
+    info.GetReturnValue().Set(Local<Array>::Cast(info[0]->ToObject()->Clone()));
+    return;
+
+  } else if (info[0]->IsDate()) {
+    info.GetReturnValue().Set(Local<Date>::Cast(info[0]->ToObject()->Clone()));
+    return;
+
+  } else if (info[0]->IsFunction()) {
+    info.GetReturnValue().Set(Local<Function>::Cast(info[0])->Clone());
+    return;
+
+  } else if (info[0]->IsNull()) {
+    info.GetReturnValue().SetNull();
+    return;
+
+  } else if (info[0]->IsUndefined()) {
+    info.GetReturnValue().SetUndefined();
+    return;
+
+  } else if (info[0]->IsObject()) {
+    info.GetReturnValue().Set(info[0]->ToObject()->Clone());
+    return;
+  }
+
+  Nan::ThrowError("clone cannot determine the type of the argument.");
+  return;
+}
+
+/**
+ *  Set or Retrieve the value of a hidden
+ *  property on a given object
+ *  Passing two arguments to this function
+ *  returns the value of the hidden property
+ *  While passing three arguments to this function
+ *  results in the setting of the hidden property
+ *  and returns a Boolean value indicating successful
+ *  setting of value
+ *
+ *  @param Object
+ *  @param String name
+ *  @param mixed value - optional
+ *  @returns mixed
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::Hidden) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("hidden requires at least two (2) arguments.");
+    return;
+  }
+
+  Local<Object> obj = info[0]->ToObject();
+
+  if (info.Length() < 3) {
+    info.GetReturnValue().Set(obj->GetHiddenValue(
+          String::Concat(Key(kKeyHiddenPrefix),
+                   Nan::To<v8::String>(info[1]).ToLocalChecked())));
+    return;
+  }
+
+  info.GetReturnValue().Set(
+    Nan::New<Boolean>(
+        obj->SetHiddenValue(String::Concat(Key(kKeyHiddenPrefix),
+                           Nan::To<v8::String>(info[1]).ToLocalChecked()),
+        info[2])));
+}
+
+/**
+ *  Set the prototype of an object
+ *
+ *  @param Object
+ *  @param Object
+ *  @returns Boolean
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::SetPrototype) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("setPrototype requires at least two (2) arguments.");
+    return;
+  }
+  info.GetReturnValue().Set(Nan::New<Boolean>(info[0]->ToObject()->SetPrototype(info[1])));
+}
+
+/**
+ *  Determine if an Object was created by Proxy
+ *
+ *  @param Object
+ *  @returns Boolean
+ */
+NAN_METHOD(NodeProxy::IsProxy) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("isProxy requires at least one (1) argument.");
+    return;
+  }
+
+  Local<Object> obj = info[0]->ToObject();
+
+  if (obj->InternalFieldCount() > 0) {
+    Local<Value> temp = obj->GetInternalField(0);
+
+    info.GetReturnValue().Set(Nan::New<Boolean>(!temp.IsEmpty() && temp->IsObject()));
+    return;
+  }
+
+  info.GetReturnValue().Set(Nan::False());
+}
+
+/**
+ *  Resolve the traps of a Proxy created object again
+ *  after its ProxyHandler has been modified
+ *
+ *  * The traps of a ProxyHandler are looked up once, when the
+ *  * first proxy is created from it. Adding, removing or replacing
+ *  * a trap on the handler afterwards has no effect until this is
+ *  * called, and then affects every proxy sharing the handler.
+ *  * It cannot add interceptors, @see NodeProxy::ShapeOf, a trap
+ *  * for an operation the proxy was created without intercepting
+ *  * only applies to proxies created after it was added
+ *
+ *  @param Object
+ *  @returns Boolean - false when the object is no longer trapping
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::RefreshHandler) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("refreshHandler requires at least one (1) argument.");
+    return;
+  }
+
+  Local<Object> obj = info[0]->ToObject();
+  HandlerRecord *record = HandlerRecord::From(obj);
+
+  if (record == NULL) {
+    Nan::ThrowTypeError("refreshHandler expects first "
+                "argument to be intialized by Proxy");
+    return;
+  }
+
+  Local<Object> handler = obj->GetInternalField(kHandlerField)->ToObject();
+
+  if (!(GetState(obj) & kStateTrapping)) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  record->Resolve(handler);
+
+  info.GetReturnValue().Set(Nan::True());
+}
+
+/**
+ *  Find the HandlerRecord of a proxy, or of a handler
+ *  that has been used to create a proxy
+ *
+ *  @param mixed
+ *  @returns HandlerRecord, or NULL
+ */
+HandlerRecord *NodeProxy::RecordOf(Local<Value> proxyOrHandler) {
+  if (!proxyOrHandler->IsObject()) {
+    return NULL;
+  }
+
+  Local<Object> obj = proxyOrHandler->ToObject();
+
+  if (obj->InternalFieldCount() >= kProxyFieldCount) {
+    return HandlerRecord::From(obj);
+  }
+
+  Local<Value> record = obj->GetHiddenValue(Key(kKeyRecord));
+
+  if (record.IsEmpty() || !record->IsObject()) {
+    return NULL;
+  }
+
+  return Nan::ObjectWrap::Unwrap<HandlerRecord>(record->ToObject());
+}
+
+/**
+ *  Turn the collection of stats on or off for every proxy
+ *
+ *  @param Boolean
+ *  @returns Boolean - whether stats were enabled before
+ */
+NAN_METHOD(NodeProxy::EnableStats) {
+  bool enabled = (TrapScope::Enabled & TrapScope::kStats) != 0;
+
+  if (info.Length() < 1 || info[0]->BooleanValue()) {
+    TrapScope::Enabled |= TrapScope::kStats;
+  } else {
+    TrapScope::Enabled &= ~TrapScope::kStats;
+  }
+
+  info.GetReturnValue().Set(Nan::New<Boolean>(enabled));
+}
+
+/**
+ *  Report the stats of a handler, shared by every proxy created
+ *  from it, as an Object with an entry for each interceptor
+ *  holding its call count, the dispatch paths it took and a
+ *  histogram of latencies, where entry i counts the calls
+ *  that took from 2^i to 2^(i+1) nanoseconds
+ *
+ *  @param Object - a proxy or a ProxyHandler
+ *  @returns Object, or null when nothing was recorded
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::Stats) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("stats requires at least one (1) argument.");
+    return;
+  }
+
+  HandlerRecord *record = RecordOf(info[0]);
+
+  if (record == NULL || record->stats == NULL) {
+    info.GetReturnValue().SetNull();
+    return;
+  }
+
+  TrapStats *stats = record->stats;
+  Local<Object> result = Nan::New<Object>();
+
+  for (int i = 0; i < kInterceptCount; ++i) {
+    Local<Object> entry = Nan::New<Object>();
+    Local<Array> latency = Nan::New<Array>(kLatencyBucketCount);
+
+    entry->Set(Nan::New<String>("calls").ToLocalChecked(),
+        Nan::New<Number>(static_cast<double>(stats->calls[i])));
+
+    if (ProxyPathNames[i][0] != NULL) {
+      Local<Object> paths = Nan::New<Object>();
+
+      for (int j = 0; j < kPathCount && ProxyPathNames[i][j] != NULL; ++j) {
+        paths->Set(Nan::New<String>(ProxyPathNames[i][j]).ToLocalChecked(),
+            Nan::New<Number>(static_cast<double>(stats->paths[i][j])));
+      }
+
+      entry->Set(Nan::New<String>("paths").ToLocalChecked(), paths);
+    }
+
+    for (int j = 0; j < kLatencyBucketCount; ++j) {
+      latency->Set(j, Nan::New<Number>(static_cast<double>(stats->latency[i][j])));
+    }
+
+    entry->Set(Nan::New<String>("latency").ToLocalChecked(), latency);
+    result->Set(Nan::New<String>(ProxyInterceptNames[i]).ToLocalChecked(), entry);
+  }
+
+  info.GetReturnValue().Set(result);
+}
+
+/**
+ *  Clear the stats of a handler
+ *
+ *  @param Object - a proxy or a ProxyHandler
+ *  @returns Boolean
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::ResetStats) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("resetStats requires at least one (1) argument.");
+    return;
+  }
+
+  HandlerRecord *record = RecordOf(info[0]);
+
+  if (record == NULL) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  delete record->stats;
+  record->stats = NULL;
+
+  info.GetReturnValue().Set(Nan::True());
+}
+
+/**
+ *  Start or stop counting the names that reach the get and set
+ *  traps of a handler, shared by every proxy created from it
+ *
+ *  * The options bound the memory used: width and depth of the
+ *  * count-min sketch and the number of names kept, as size
+ *
+ *  @param Object - a proxy or a ProxyHandler
+ *  @param Object|Boolean - optional, options or false to stop
+ *  @returns Boolean
+ *  @throws Error, TypeError, RangeError
+ */
+NAN_METHOD(NodeProxy::TrackHotKeys) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("trackHotKeys requires at least one (1) argument.");
+    return;
+  }
+
+  HandlerRecord *record = RecordOf(info[0]);
+
+  if (record == NULL) {
+    Nan::ThrowTypeError("trackHotKeys expects first argument to be "
+                "intialized by Proxy, or the handler of a Proxy");
+    return;
+  }
+
+  if (info.Length() > 1 && info[1]->IsFalse()) {
+    delete record->hotKeys;
+    record->hotKeys = NULL;
+    info.GetReturnValue().Set(Nan::True());
+    return;
+  }
+
+  uint32_t width = 1024;
+  uint32_t depth = 4;
+  uint32_t size = 16;
+
+  if (info.Length() > 1 && info[1]->IsObject()) {
+    Local<Object> options = info[1]->ToObject();
+    Local<Value> value;
+
+    value = options->Get(Nan::New<String>("width").ToLocalChecked());
+    if (value->IsUint32() && value->Uint32Value() > 0) {
+      width = value->Uint32Value();
+    }
+
+    value = options->Get(Nan::New<String>("depth").ToLocalChecked());
+    if (value->IsUint32() && value->Uint32Value() > 0) {
+      depth = value->Uint32Value();
+    }
+
+    value = options->Get(Nan::New<String>("size").ToLocalChecked());
+    if (value->IsUint32()) {
+      size = value->Uint32Value();
+    }
+  }
+
+  if (static_cast<uint64_t>(width) * depth > HotKeySketch::kMaxCounters) {
+    Nan::ThrowRangeError("trackHotKeys allows a width * depth of at most 16777216.");
+    return;
+  }
+
+  if (size > HotKeySketch::kMaxSize) {
+    Nan::ThrowRangeError("trackHotKeys allows a size of at most 65536.");
+    return;
+  }
+
+  delete record->hotKeys;
+  record->hotKeys = new HotKeySketch(width, depth, size);
+
+  info.GetReturnValue().Set(Nan::True());
+}
+
+/**
+ *  The names that reached the get and set traps of a
+ *  handler most often, with their approximate counts
+ *
+ *  @param Object - a proxy or a ProxyHandler
+ *  @param Integer - optional, the number of names
+ *  @returns Array - of { name, count }, most frequent first
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::HotKeys) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("hotKeys requires at least one (1) argument.");
+    return;
+  }
+
+  HandlerRecord *record = RecordOf(info[0]);
+
+  if (record == NULL || record->hotKeys == NULL) {
+    info.GetReturnValue().Set(Nan::New<Array>());
+    return;
+  }
+
+  uint32_t k = info.Length() > 1 && info[1]->IsUint32() ?
+               info[1]->Uint32Value() : 10;
+  std::vector<HotKeySketch::Entry> top = record->hotKeys->Top(k);
+  Local<Array> result = Nan::New<Array>(top.size());
+
+  for (size_t i = 0; i < top.size(); ++i) {
+    Local<Object> entry = Nan::New<Object>();
+
+    entry->Set(Nan::New<String>("name").ToLocalChecked(),
+        Nan::New<String>(top[i].name.data(), top[i].name.size()).ToLocalChecked());
+    entry->Set(Nan::New<String>("count").ToLocalChecked(),
+        Nan::New<Number>(top[i].count));
+    result->Set(i, entry);
+  }
+
+  info.GetReturnValue().Set(result);
+}
+
+/**
+ *  Report the hits, misses and evictions of the cache
+ *  of a proxy made by createCached, and of its cache of
+ *  query results as queries
+ *
+ *  @param Object - a proxy
+ *  @returns Object, or null unless the proxy caches
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::CacheStats) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("cacheStats requires at least one (1) argument.");
+    return;
+  }
+
+  ProxyExtension *caching = info[0]->IsObject() ?
+      Caching(info[0]->ToObject(), kStateCaching | kStateCachingQueries) : NULL;
+
+  if (caching == NULL) {
+    info.GetReturnValue().SetNull();
+    return;
+  }
+
+  Local<Object> result = Nan::New<Object>();
+
+  if (caching->cache != NULL) {
+    ReadCache *cache = caching->cache;
+
+    result->Set(Nan::New<String>("hits").ToLocalChecked(),
+        Nan::New<Number>(cache->hits()));
+    result->Set(Nan::New<String>("misses").ToLocalChecked(),
+        Nan::New<Number>(cache->misses()));
+    result->Set(Nan::New<String>("evictions").ToLocalChecked(),
+        Nan::New<Number>(cache->evictions()));
+    result->Set(Nan::New<String>("size").ToLocalChecked(),
+        Nan::New<Number>(cache->size()));
+    result->Set(Key(kKeyMaxEntries),
+        Nan::New<Number>(cache->capacity()));
+    result->Set(Key(kKeyTtlMs),
+        Nan::New<Number>(static_cast<double>(cache->ttl()) / 1e6));
+  }
+
+  if (caching->attributes != NULL) {
+    const ReadCache &names = caching->attributes->names();
+    Local<Object> queries = Nan::New<Object>();
+
+    queries->Set(Nan::New<String>("hits").ToLocalChecked(),
+        Nan::New<Number>(names.hits()));
+    queries->Set(Nan::New<String>("misses").ToLocalChecked(),
+        Nan::New<Number>(names.misses()));
+    queries->Set(Nan::New<String>("evictions").ToLocalChecked(),
+        Nan::New<Number>(names.evictions()));
+    queries->Set(Nan::New<String>("size").ToLocalChecked(),
+        Nan::New<Number>(names.size()));
+    queries->Set(Key(kKeyMaxEntries),
+        Nan::New<Number>(names.capacity()));
+    result->Set(Nan::New<String>("queries").ToLocalChecked(), queries);
+  }
+
+  info.GetReturnValue().Set(result);
+}
+
+/**
+ *  Drop a name, or every name, from the cache of a proxy
+ *  made by createCached, for when the handler changes
+ *  what it returns
+ *
+ *  @param Object - a proxy
+ *  @param String|Integer - optional, the name
+ *  @returns Boolean - whether the proxy caches
+ *  @throws Error
+ */
+NAN_METHOD(NodeProxy::ClearCache) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("clearCache requires at least one (1) argument.");
+    return;
+  }
+
+  ProxyExtension *caching = info[0]->IsObject() ?
+      Caching(info[0]->ToObject(), kStateCaching | kStateCachingQueries) : NULL;
+
+  if (caching == NULL) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  if (info.Length() < 2 || info[1]->IsUndefined()) {
+    caching->ForgetAll();
+  } else if (info[1]->IsUint32()) {
+    caching->Forget(PropertyName(info[1]->Uint32Value()));
+  } else {
+    caching->Forget(PropertyName(info[1]->ToString()));
+  }
+
+  info.GetReturnValue().Set(Nan::True());
+}
+
+/**
+ *  Turn tracing of interceptor calls on or off, enabling
+ *  it also empties the trace ring buffer
+ *
+ *  @param Boolean
+ *  @returns Boolean - whether tracing was enabled before
+ */
+NAN_METHOD(NodeProxy::EnableTrace) {
+  bool enabled = (TrapScope::Enabled & TrapScope::kTrace) != 0;
+
+  if (info.Length() < 1 || info[0]->BooleanValue()) {
+    TrapScope::Enabled |= TrapScope::kTrace;
+    TrapScope::TraceCount = 0;
+  } else {
+    TrapScope::Enabled &= ~TrapScope::kTrace;
+  }
+
+  info.GetReturnValue().Set(Nan::New<Boolean>(enabled));
+}
+
+/**
+ *  Export the trace ring buffer as Chrome trace-event JSON,
+ *  every proxy is reported as its own thread and the number
+ *  of calls overwritten in the ring buffer as otherData.dropped
+ *
+ *  @returns String
+ */
+NAN_METHOD(NodeProxy::DumpTrace) {
+  uint64_t count = TrapScope::TraceCount;
+  uint64_t first = count > kTraceCapacity ? count - kTraceCapacity : 0;
+  std::string out;
+  char number[160];
+
+  out.reserve(static_cast<size_t>(count - first) * 128 + 64);
+  out.append("{\"traceEvents\":[");
+
+  for (uint64_t i = first; i < count; ++i) {
+    const TraceEntry &entry = TrapScope::Trace[i % kTraceCapacity];
+    const char *trap = ProxyInterceptNames[entry.intercept];
+
+    if (i != first) {
+      out.push_back(',');
+    }
+
+    out.append("{\"name\":");
+
+    if (entry.index != TrapScope::kNoIndex) {
+      snprintf(number, sizeof(number), "%s %u", trap, entry.index);
+      AppendJSONString(&out, number, strlen(number));
+    } else {
+      std::string name(trap);
+      name.push_back(' ');
+      name.append(entry.name, entry.nameLength);
+      AppendJSONString(&out, name.data(), name.size());
+    }
+
+    snprintf(number, sizeof(number),
+             ",\"cat\":\"proxy\",\"ph\":\"X\",\"pid\":1,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f",
+             entry.proxy, entry.start / 1000.0, entry.duration / 1000.0);
+    out.append(number);
+    out.append(",\"args\":{\"trap\":");
+    AppendJSONString(&out, trap, strlen(trap));
+    out.append("}}");
+  }
+
+  snprintf(number, sizeof(number), "],\"otherData\":{\"dropped\":%llu}}",
+           static_cast<unsigned long long>(first));
+  out.append(number);
+
+  info.GetReturnValue().Set(Nan::New<String>(out.data(), out.size()).ToLocalChecked());
+}
+
+/**
+ *  Create an object that has ProxyHandler intercepts attached and
+ *  optionally implements the prototype of another object
+ *
+ *  * ProxyHandler intercepts override the property handlers for any
+ *  * given prototype. So, the ProxyHandler will be invoked for access
+ *  * to the prototype's properties as well
+ *
+ *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
+ *  @param Object - optional, the prototype object to implement
+ *  @returns Object
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::Create) {
+
+  Local<Object> proxyHandler;
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("create requires at least one (1) argument.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError(
+        "create requires the first argument to be an Object.");
+    return;
+  }
+
+  proxyHandler = info[0]->ToObject();
+
+  if (info.Length() > 1 && !info[1]->IsObject() && !info[1]->IsUndefined()) {
+    Nan::ThrowTypeError(
+        "create requires the second argument to be an Object.");
+    return;
+  }
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[2], &options)) {
+    return;
+  }
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> instance = Template(shape)->NewInstance();
+
+  instance->SetInternalField(kHandlerField, proxyHandler);
+  instance->SetInternalField(kRecordField, record);
+
+  // manage locking states
+  SetState(instance, kStateTrapping | kStateExtensible | Extend(instance, options));
+  DefineStatics(instance, options);
+
+  if (info.Length() > 1 && info[1]->IsObject()) {
+    instance->SetPrototype(info[1]);
+  }
+
+  info.GetReturnValue().Set(instance);
+}
+
+/**
+ *  Create a function that has ProxyHandler intercepts attached and
+ *  sets a call trap function for invokation as well as an optional
+ *  constructor trap
+ *
+ *
+ *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
+ *  @param Function - call trap
+ *  @param Function - optional, constructor trap
+ *  @returns Function
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::CreateFunction) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("createFunction requires at least two (2) arguments.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError("createFunction requires the first argument to be an Object.");
+    return;
+  }
+  Local<Object> proxyHandler = info[0]->ToObject();
+
+  if (!info[1]->IsFunction()) {
+    Nan::ThrowTypeError("createFunction requires the second argument to be a Function.");
+    return;
+  }
+
+  if (info.Length() > 2 && !info[2]->IsFunction() && !info[2]->IsUndefined()) {
+    Nan::ThrowTypeError("createFunction requires the second argument to be a Function.");
+    return;
+  }
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[3], &options)) {
+    return;
+  }
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> fn = Template(shape | kShapeFunction)->NewInstance();
+  fn->SetPrototype(info[1]->ToObject()->GetPrototype());
+
+  fn->SetInternalField(kHandlerField, proxyHandler);
+  fn->SetInternalField(kRecordField, record);
+  fn->SetInternalField(kCallTrapField, info[1]);
+
+  if (info.Length() > 2) {
+    fn->SetInternalField(kConstructorTrapField, info[2]);
+  } else {
+    fn->SetInternalField(kConstructorTrapField, Nan::Undefined());
+  }
+
+  // manage locking states
+  SetState(fn, kStateTrapping | kStateExtensible | Extend(fn, options));
+  DefineStatics(fn, options);
+
+  info.GetReturnValue().Set(fn);
+}
+
+/**
+ *  Create an object that forwards every access its ProxyHandler
+ *  does not trap to a target object, without calling into JS
+ *
+ *  * A trap can also return Proxy.forward to have a single
+ *  * access forwarded to the target
+ *
+ *  @param Object - the target
+ *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
+ *  @param Object - optional, @see NodeProxy::ReadOptions
+ *  @returns Object
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::CreateForwarding) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("createForwarding requires at least two (2) arguments.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError(
+        "createForwarding requires the first argument to be an Object.");
+    return;
+  }
+
+  if (!info[1]->IsObject()) {
+    Nan::ThrowTypeError(
+        "createForwarding requires the second argument to be an Object.");
+    return;
+  }
+
+  Local<Object> target = info[0]->ToObject();
+  Local<Object> proxyHandler = info[1]->ToObject();
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[2], &options)) {
+    return;
+  }
+
+  options.target = target;
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> instance = Template(shape)->NewInstance();
+
+  instance->SetInternalField(kHandlerField, proxyHandler);
+  instance->SetInternalField(kRecordField, record);
+
+  // manage locking states
+  SetState(instance, kStateTrapping | kStateExtensible | Extend(instance, options));
+  DefineStatics(instance, options);
+
+  instance->SetPrototype(target->GetPrototype());
+
+  info.GetReturnValue().Set(instance);
+}
+
+/**
+ *  Create an object whose get results are remembered in a
+ *  native least recently used cache, so that repeated reads
+ *  of a name do not call into the handler
+ *
+ *  * Setting, deleting or defining a property through the proxy
+ *  * drops it from the cache, changes made by the handler to
+ *  * other names are only seen once their entries expire
+ *
+ *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
+ *  @param Object - optional, maxEntries (1024, at most 2^20), ttlMs
+ *                  (0, never expire, at most a year) and the options of create
+ *  @param Object - optional, the prototype
+ *  @returns Object
+ *  @throws Error, TypeError, RangeError
+ */
+NAN_METHOD(NodeProxy::CreateCached) {
+
+  if (info.Length() < 1) {
+    Nan::ThrowError("createCached requires at least one (1) argument.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError(
+        "createCached requires the first argument to be an Object.");
+    return;
+  }
+
+  if (info.Length() > 2 && !info[2]->IsObject() && !info[2]->IsUndefined()) {
+    Nan::ThrowTypeError(
+        "createCached requires the third argument to be an Object.");
+    return;
+  }
+
+  Local<Object> proxyHandler = info[0]->ToObject();
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[1], &options)) {
+    return;
+  }
+
+  options.maxEntries = 1024;
+
+  if (info[1]->IsObject()) {
+    Local<Object> obj = info[1]->ToObject();
+    Local<Value> value;
+
+    value = obj->Get(Key(kKeyMaxEntries));
+    if (value->IsUint32() && value->Uint32Value() > 0) {
+      if (value->Uint32Value() > ReadCache::kMaxCapacity) {
+        Nan::ThrowRangeError("createCached allows at most 1048576 maxEntries.");
+        return;
+      }
+      options.maxEntries = value->Uint32Value();
+    }
+
+    value = obj->Get(Key(kKeyTtlMs));
+    if (value->IsNumber() && value->NumberValue() > 0) {
+      if (!(value->NumberValue() <= kMaxCacheTtl)) {
+        Nan::ThrowRangeError("createCached allows a ttlMs of at most one year.");
+        return;
+      }
+      options.ttl = static_cast<uint64_t>(value->NumberValue() * 1e6);
+    }
+  }
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> instance = Template(shape)->NewInstance();
+
+  instance->SetInternalField(kHandlerField, proxyHandler);
+  instance->SetInternalField(kRecordField, record);
+
+  // manage locking states
+  SetState(instance, kStateTrapping | kStateExtensible | Extend(instance, options));
+  DefineStatics(instance, options);
+
+  if (info.Length() > 2 && info[2]->IsObject()) {
+    instance->SetPrototype(info[2]);
+  }
+
+  info.GetReturnValue().Set(instance);
+}
+
+/**
+ *  Create an object whose indexed properties are the elements
+ *  of a typed array, read and written natively, its handler
+ *  only sees named properties and indices past the end
+ *
+ *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
+ *  @param TypedArray - Float64Array, Int32Array, Uint8Array...
+ *  @param Object - optional, @see NodeProxy::ReadOptions
+ *  @returns Object
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::CreateArrayView) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("createArrayView requires at least two (2) arguments.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError(
+        "createArrayView requires the first argument to be an Object.");
+    return;
+  }
+
+  if (ArrayView::KindOf(info[1]) == ArrayView::kNone) {
+    Nan::ThrowTypeError(
+        "createArrayView requires the second argument to be a TypedArray.");
+    return;
+  }
+
+  Local<Object> proxyHandler = info[0]->ToObject();
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[2], &options)) {
+    return;
+  }
+
+  options.view = info[1];
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> instance = Template(shape)->NewInstance();
+
+  instance->SetInternalField(kHandlerField, proxyHandler);
+  instance->SetInternalField(kRecordField, record);
+
+  // manage locking states
+  SetState(instance, kStateTrapping | kStateExtensible | Extend(instance, options));
+  DefineStatics(instance, options);
+
+  info.GetReturnValue().Set(instance);
+}
+
+/**
+ *  Create a proxy over a record of a binary buffer, the
+ *  fields named by the schema are read and written in native
+ *  code and never reach the handler
+ *
+ *  @param Object - field names to "<type>@<offset>" specs,
+ *                  @see StructLayout
+ *  @param ArrayBuffer|TypedArray|Buffer
+ *  @param Number - optional, the byte offset of the record
+ *  @param ProxyHandler - optional, traps the names outside the schema
+ *  @param Object - optional, @see NodeProxy::ReadOptions
+ *  @returns Object
+ *  @throws Error, TypeError, RangeError
+ */
+NAN_METHOD(NodeProxy::CreateStruct) {
+
+  if (info.Length() < 2) {
+    Nan::ThrowError("createStruct requires at least two (2) arguments.");
+    return;
+  }
+
+  if (!info[0]->IsObject()) {
+    Nan::ThrowTypeError(
+        "createStruct requires the first argument to be an Object.");
+    return;
+  }
+
+  Local<Value> bytes = info[1];
+
+#if PROXY_NODE_VERSION_AT_LEAST(0, 12, 0)
+  if (bytes->IsArrayBuffer()) {
+    Local<ArrayBuffer> buffer = Local<ArrayBuffer>::Cast(bytes);
+    bytes = Uint8Array::New(buffer, 0, buffer->ByteLength());
+  } else if (!bytes->IsArrayBufferView()) {
+    bytes = Local<Value>();
+  }
+#else
+  // before 0.12 only byte arrays expose their length in bytes
+  ArrayView::Kind kind = ArrayView::KindOf(bytes);
+
+  if (kind != ArrayView::kInt8 && kind != ArrayView::kUint8 &&
+      kind != ArrayView::kUint8Clamped) {
+    bytes = Local<Value>();
+  }
+#endif
+
+  if (bytes.IsEmpty()) {
+    Nan::ThrowTypeError("createStruct requires the second argument "
+                        "to be an ArrayBuffer, a TypedArray or a Buffer.");
+    return;
+  }
+
+  uint32_t byteOffset = 0;
+
+  if (info.Length() > 2 && !info[2]->IsUndefined()) {
+    if (!info[2]->IsUint32()) {
+      Nan::ThrowTypeError(
+          "createStruct requires the byte offset to be a non-negative integer.");
+      return;
+    }
+
+    byteOffset = info[2]->Uint32Value();
+  }
+
+  bool handled = info.Length() > 3 && info[3]->IsObject();
+
+  if (info.Length() > 3 && !handled && !info[3]->IsUndefined() && !info[3]->IsNull()) {
+    Nan::ThrowTypeError("createStruct requires the handler to be an Object.");
+    return;
+  }
+
+  Local<Object> layout = StructRecord::For(info[0]->ToObject());
+
+  if (layout.IsEmpty()) {
+    return;
+  }
+
+  StructRecord *schema = Nan::ObjectWrap::Unwrap<StructRecord>(layout);
+  Nan::TypedArrayContents<uint8_t> contents(bytes);
+
+  if (contents.length() < static_cast<size_t>(byteOffset) + schema->layout.size()) {
+    Nan::ThrowRangeError(
+        "createStruct requires the buffer to hold every field of the schema.");
+    return;
+  }
+
+  Local<Object> proxyHandler = handled ? info[3]->ToObject() :
+      layout->GetInternalField(StructRecord::kHandlerField)->ToObject();
+
+  ProxyOptions options;
+
+  if (!ReadOptions(info[4], &options)) {
+    return;
+  }
+
+  options.layout = layout;
+  options.bytes = bytes;
+  options.byteOffset = byteOffset;
+  options.trapsUnknown = handled;
+
+  // without a handler, indices are left to V8 as well
+  if (!handled) {
+    options.indexed = false;
+  }
+
+  Local<Object> record = HandlerRecord::For(proxyHandler);
+  uint32_t shape = ShapeOf(Nan::ObjectWrap::Unwrap<HandlerRecord>(record), options);
+  Local<Object> instance = Template(shape)->NewInstance();
+
+  instance->SetInternalField(kHandlerField, proxyHandler);
+  instance->SetInternalField(kRecordField, record);
+
+  // manage locking states
+  SetState(instance, kStateTrapping | kStateExtensible | Extend(instance, options));
+  DefineStatics(instance, options);
+
+  info.GetReturnValue().Set(instance);
+}
+
+/**
+ *  Read several properties at once, with a single call to the
+ *  getMany trap when the handler of the proxy has one, otherwise
+ *  through the interceptors, one name after the other, without
+ *  returning to JS in between
+ *
+ *  @param Object
+ *  @param Array - property names or indices
+ *  @returns Array - the values, in the order of names
+ *  @throws Error, TypeError
+ */
+NAN_METHOD(NodeProxy::GetMany) {
 
-  if (info.Length() < 1) {
-    Nan::ThrowError("create requires at least one (1) argument.");
+  if (info.Length() < 2) {
+    Nan::ThrowError("getMany requires at least two (2) arguments.");
     return;
   }
 
-  if (!info[0]->IsObject()) {
+  if (!info[0]->IsObject() || !info[1]->IsArray()) {
     Nan::ThrowTypeError(
-        "create requires the first argument to be an Object.");
+        "getMany requires an Object and an Array of names.");
     return;
   }
 
-  proxyHandler = info[0]->ToObject();
+  Local<Object> obj = info[0]->ToObject();
+  Local<Array> names = Local<Array>::Cast(info[1]);
+  HandlerRecord *record = BulkRecord(obj, kTrapGetMany);
 
-  if (info.Length() > 1 && !info[1]->IsObject()) {
-    Nan::ThrowTypeError(
-        "create requires the second argument to be an Object.");
-    return;
+  // fall back to single gets when the trap does not return an Array
+  if (record != NULL) {
+    Local<Value> argv[1] = {names};
+    Local<Object> handler = obj->GetInternalField(kHandlerField)->ToObject();
+    Local<Value> values = record->Trap(kTrapGetMany)->Call(handler, 1, argv);
+
+    if (values.IsEmpty()) {
+      return;
+    }
+
+    if (values->IsArray()) {
+      info.GetReturnValue().Set(values);
+      return;
+    }
   }
 
-  // manage locking states
-  proxyHandler->SetHiddenValue(Nan::New<String>("trapping").ToLocalChecked(), Nan::True());
-  proxyHandler->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::True());
-  proxyHandler->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::False());
-  proxyHandler->SetHiddenValue(Nan::New<String>("frozen").ToLocalChecked(), Nan::False());
+  uint32_t length = names->Length();
+  Local<Array> values = Nan::New<Array>(static_cast<int>(length));
+  Nan::TryCatch tc;
 
-  Local<Object> instance = Nan::New<ObjectTemplate>(ObjectCreator)->NewInstance();
+  // stop at the first name or trap that throws
+  for (uint32_t i = 0; i < length; ++i) {
+    Nan::HandleScope scope;
 
-  instance->SetInternalField(0, proxyHandler);
+    Local<Value> name = names->Get(i);
 
-  if (info.Length() > 1) {
-    instance->SetPrototype(info[1]);
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return;
+    }
+
+    Local<Value> value = obj->Get(name);
+
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return;
+    }
+
+    values->Set(i, value);
   }
 
-  info.GetReturnValue().Set(instance);
+  info.GetReturnValue().Set(values);
 }
 
 /**
- *  Create a function that has ProxyHandler intercepts attached and
- *  sets a call trap function for invokation as well as an optional
- *  constructor trap
- *
+ *  Write several properties at once, with a single call to the
+ *  setMany trap when the handler of the proxy has one, otherwise
+ *  through the interceptors, one name after the other
  *
- *  @param ProxyHandler - @see NodeProxy::ValidateProxyHandler
- *  @param Function - call trap
- *  @param Function - optional, constructor trap
- *  @returns Function
+ *  @param Object
+ *  @param Object - the values to write, by name
+ *  @returns Boolean
  *  @throws Error, TypeError
  */
-NAN_METHOD(NodeProxy::CreateFunction) {
+NAN_METHOD(NodeProxy::SetMany) {
 
   if (info.Length() < 2) {
-    Nan::ThrowError("createFunction requires at least two (2) arguments.");
+    Nan::ThrowError("setMany requires at least two (2) arguments.");
     return;
   }
 
-  if (!info[0]->IsObject()) {
-    Nan::ThrowTypeError("createFunction requires the first argument to be an Object.");
+  if (!info[0]->IsObject() || !info[1]->IsObject()) {
+    Nan::ThrowTypeError("setMany requires two Objects.");
     return;
   }
-  Local<Object> proxyHandler = info[0]->ToObject();
 
-  if (!info[1]->IsFunction()) {
-    Nan::ThrowTypeError("createFunction requires the second argument to be a Function.");
+  Local<Object> obj = info[0]->ToObject();
+  Local<Object> entries = info[1]->ToObject();
+  Nan::TryCatch tc;
+  Local<Array> names = entries->GetOwnPropertyNames();
+
+  if (tc.HasCaught()) {
+    tc.ReThrow();
     return;
   }
 
-  if (info.Length() > 2 && !info[2]->IsFunction()) {
-    Nan::ThrowTypeError("createFunction requires the second argument to be a Function.");
+  uint32_t length = names->Length();
+  HandlerRecord *record = BulkRecord(obj, kTrapSetMany);
+
+  if (record != NULL) {
+    // the trap skips the setter, so drop the cached
+    // results of every name it writes
+    for (uint32_t i = 0; i < length; ++i) {
+      Invalidate(obj, names->Get(i)->ToString());
+    }
+
+    Local<Value> argv[1] = {entries};
+    Local<Object> handler = obj->GetInternalField(kHandlerField)->ToObject();
+
+    if (record->Trap(kTrapSetMany)->Call(handler, 1, argv).IsEmpty()) {
+      tc.ReThrow();
+      return;
+    }
+
+    info.GetReturnValue().Set(Nan::True());
     return;
   }
 
-  proxyHandler->SetHiddenValue(Nan::New<String>("callTrap").ToLocalChecked(), info[1]);
-  Local<Value> constructorTrap;
-  if(info.Length() > 2) {
-    constructorTrap = info[2];
-  } else {
-    constructorTrap = Nan::Undefined();
-  }
-  proxyHandler->SetHiddenValue(Nan::New<String>("constructorTrap").ToLocalChecked(), constructorTrap);
+  // stop at the first entry or trap that throws
+  for (uint32_t i = 0; i < length; ++i) {
+    Nan::HandleScope scope;
 
-  // manage locking states
-  proxyHandler->SetHiddenValue(Nan::New<String>("trapping").ToLocalChecked(), Nan::True());
-  proxyHandler->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::True());
-  proxyHandler->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::False());
-  proxyHandler->SetHiddenValue(Nan::New<String>("frozen").ToLocalChecked(), Nan::False());
+    Local<Value> name = names->Get(i);
+    Local<Value> value = entries->Get(name);
 
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return;
+    }
 
-  Local<Object> fn = Nan::New<ObjectTemplate>(FunctionCreator)->NewInstance();
-  fn->SetPrototype(info[1]->ToObject()->GetPrototype());
+    obj->Set(name, value);
 
-  fn->SetInternalField(0, proxyHandler);
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return;
+    }
+  }
 
-  info.GetReturnValue().Set(fn);
+  info.GetReturnValue().Set(Nan::True());
 }
 
 /**
  *  Used as a handler for freeze, seal, and preventExtensions
  *  to lock the state of a Proxy created object
  *
+ *  * A proxy created with materialize gets the descriptors as
+ *  * own properties, but reads still cross its interceptors, so
+ *  * the lock also returns a plain copy, @see NodeProxy::PlainCopy
+ *
  *  @param Object
- *  @returns Boolean
+ *  @returns Boolean, or the plain copy of a materialized proxy
  *  @throws Error, TypeError
  */
 NAN_METHOD(NodeProxy::Freeze) {
 
-  Local<String> name = info.Callee()->GetName()->ToString();
+  ProxyLock lock = static_cast<ProxyLock>(info.Data()->Int32Value());
 
   if (info.Length() < 1) {
-    Nan::ThrowError(String::Concat(name,
+    Nan::ThrowError(String::Concat(Key(ProxyLockNames[lock]),
              Nan::New<String>(" requires at least one (1) argument.").ToLocalChecked()));
     return;
   }
 
   Local<Object> obj = info[0]->ToObject();
 
-  if (obj->InternalFieldCount() < 1) {
+  if (obj->InternalFieldCount() < kProxyFieldCount) {
     Nan::ThrowTypeError(
       "Locking functions expect first "
       "argument to be intialized by Proxy");
     return;
   }
 
-  Local<Value> hide = obj->GetInternalField(0);
+  Local<Value> hide = obj->GetInternalField(kHandlerField);
 
   if (hide.IsEmpty() || !hide->IsObject()) {
     Nan::ThrowTypeError(
@@ -341,52 +3047,31 @@ NAN_METHOD(NodeProxy::Freeze) {
     return;
   }
 
-  Local<Object> handler = hide->ToObject();
+  uint32_t state = GetState(obj);
+  uint32_t locked = LockState(lock, state);
 
   // if the object already meets the requirements of the function call
-  if (name->Equals(Nan::New<String>("freeze").ToLocalChecked())) {
-    if (handler->GetHiddenValue(Nan::New<String>("frozen").ToLocalChecked())->BooleanValue()) {
-      info.GetReturnValue().Set(Nan::True());
-      return;
-    }
-
-  } else if (name->Equals(Nan::New<String>("seal").ToLocalChecked())) {
-    if (handler->GetHiddenValue(Nan::New<String>("sealed").ToLocalChecked())->BooleanValue()) {
-      info.GetReturnValue().Set(Nan::True());
-      return;
-    }
-
-  } else if (name->Equals(Nan::New<String>("preventExtensions").ToLocalChecked())) {
-    if (handler->GetHiddenValue(Nan::New<String>("extensible").ToLocalChecked())->BooleanValue()) {
-      info.GetReturnValue().Set(Nan::True());
-      return;
-    }
+  if (locked == state) {
+    info.GetReturnValue().Set(Nan::True());
+    return;
   }
 
   // if this object is not trapping, just set the appropriate parameters
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
-    if (name->Equals(Nan::New<String>("freeze").ToLocalChecked())) {
-      handler->SetHiddenValue(Nan::New<String>("frozen").ToLocalChecked(), Nan::True());
-      handler->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::True());
-      handler->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
-      info.GetReturnValue().Set(Nan::True());
-      return;
+  if (!(state & kStateTrapping)) {
+    SetState(obj, locked);
+    info.GetReturnValue().Set(Nan::True());
+    return;
+  }
 
-    } else if (name->Equals(Nan::New<String>("seal").ToLocalChecked())) {
-      handler->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::True());
-      handler->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
-      info.GetReturnValue().Set(Nan::True());
-      return;
+  HandlerRecord *record = HandlerRecord::From(obj);
 
-    } else if (name->Equals(Nan::New<String>("preventExtensions").ToLocalChecked())) {
-      handler->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
-      info.GetReturnValue().Set(Nan::True());
-      return;
-    }
+  if (record == NULL || !record->HasTrap(kTrapFix)) {
+    Nan::ThrowTypeError("Cannot lock object.");
+    return;
   }
 
   // Harmony Proxy handling of fix
-  Local<Function> fix = Local<Function>::Cast(handler->Get(Nan::New<String>("fix").ToLocalChecked()));
+  Local<Function> fix = record->Trap(kTrapFix);
 #ifdef _WIN32
   // On windows you get "error C2466: cannot allocate an array of constant size 0" and we use a pointer
   Local<Value>* argv;
@@ -400,26 +3085,25 @@ NAN_METHOD(NodeProxy::Freeze) {
     return;
   }
 
-  Local<Object> parts = pieces->ToObject();
-
-  // set the appropriate parameters
-  if (name->Equals(Nan::New<String>("freeze").ToLocalChecked())) {
-    parts->SetHiddenValue(Nan::New<String>("frozen").ToLocalChecked(), Nan::True());
-    parts->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::True());
-    parts->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
-
-  } else if (name->Equals(Nan::New<String>("seal").ToLocalChecked())) {
-    parts->SetHiddenValue(Nan::New<String>("sealed").ToLocalChecked(), Nan::True());
-    parts->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
+  // overwrite the handler, making handler available for GC
+  obj->SetInternalField(kHandlerField, pieces->ToObject());
+  SetState(obj, locked & ~kStateTrapping);
 
-  } else if (name->Equals(Nan::New<String>("preventExtensions").ToLocalChecked())) {
-    parts->SetHiddenValue(Nan::New<String>("extensible").ToLocalChecked(), Nan::False());
+  // a locked proxy is answered by the descriptors, not the caches
+  if (locked & (kStateCaching | kStateCachingQueries)) {
+    ProxyExtension::From(obj)->ForgetAll();
   }
 
-  parts->SetHiddenValue(Nan::New<String>("trapping").ToLocalChecked(), Nan::False());
+  if (locked & kStateMaterialize) {
+    Materialize(obj, pieces->ToObject(), locked);
 
-  // overwrite the handler, making handler available for GC
-  obj->SetInternalField(0, parts);
+    Local<Value> plain = PlainCopy(obj, pieces->ToObject(), lock);
+
+    if (!plain.IsEmpty()) {
+      info.GetReturnValue().Set(plain);
+    }
+    return;
+  }
 
   info.GetReturnValue().Set(Nan::True());
 }
@@ -434,24 +3118,24 @@ NAN_METHOD(NodeProxy::Freeze) {
  */
 NAN_METHOD(NodeProxy::IsLocked) {
 
-  Local<String> name = info.Callee()->GetName()->ToString();
+  ProxyLock lock = static_cast<ProxyLock>(info.Data()->Int32Value());
 
   if (info.Length() < 1) {
-    Nan::ThrowError(String::Concat(name,
+    Nan::ThrowError(String::Concat(Key(ProxyLockNames[lock]),
              Nan::New<String>(" requires at least one (1) argument.").ToLocalChecked()));
     return;
   }
 
   Local<Object> arg = info[0]->ToObject();
 
-  if (arg->InternalFieldCount() < 1) {
+  if (arg->InternalFieldCount() < kProxyFieldCount) {
     Nan::ThrowTypeError(
        "Locking functions expect first argument "
        "to be intialized by Proxy");
     return;
   }
 
-  Local<Value> hide = arg->GetInternalField(0);
+  Local<Value> hide = arg->GetInternalField(kHandlerField);
 
   if (hide.IsEmpty() || !hide->IsObject()) {
     Nan::ThrowTypeError(
@@ -460,23 +3144,27 @@ NAN_METHOD(NodeProxy::IsLocked) {
     return;
   }
 
-  Local<Object> obj = hide->ToObject();
+  uint32_t state = GetState(arg);
 
-  if (name->Equals(Nan::New<String>("isExtensible").ToLocalChecked())) {
-    info.GetReturnValue().Set(obj->GetHiddenValue(Nan::New<String>("extensible").ToLocalChecked())->ToBoolean());
-    return;
+  switch (lock) {
+    case kLockIsExtensible:
+      info.GetReturnValue().Set(Nan::New<Boolean>((state & kStateExtensible) != 0));
+      return;
 
-  } else if (name->Equals(Nan::New<String>("isSealed").ToLocalChecked())) {
-    info.GetReturnValue().Set(obj->GetHiddenValue(Nan::New<String>("sealed").ToLocalChecked())->ToBoolean());
-    return;
+    case kLockIsSealed:
+      info.GetReturnValue().Set(Nan::New<Boolean>((state & kStateSealed) != 0));
+      return;
 
-  } else if (name->Equals(Nan::New<String>("isTrapping").ToLocalChecked())) {
-    info.GetReturnValue().Set(obj->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->ToBoolean());
-    return;
+    case kLockIsTrapping:
+      info.GetReturnValue().Set(Nan::New<Boolean>((state & kStateTrapping) != 0));
+      return;
 
-  } else if (name->Equals(Nan::New<String>("isFrozen").ToLocalChecked())) {
-    info.GetReturnValue().Set(obj->GetHiddenValue(Nan::New<String>("frozen").ToLocalChecked())->ToBoolean());
-    return;
+    case kLockIsFrozen:
+      info.GetReturnValue().Set(Nan::New<Boolean>((state & kStateFrozen) != 0));
+      return;
+
+    default:
+      break;
   }
 
   info.GetReturnValue().Set(Nan::False());
@@ -524,16 +3212,21 @@ NAN_METHOD(NodeProxy::GetOwnPropertyDescriptor) {
 
   Local<Object> handler = temp->ToObject();
 
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+  if (!(GetState(obj) & kStateTrapping)) {
     info.GetReturnValue().Set(handler->Get(name));
     return;
   }
 
-  Local<Function> getOwn = Local<Function>::Cast(
-       handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked()));
+  HandlerRecord *record = HandlerRecord::From(obj);
+
+  if (record == NULL || !record->HasTrap(kTrapGetOwnPropertyDescriptor)) {
+    info.GetReturnValue().SetUndefined();
+    return;
+  }
 
   Local<Value> argv[1] = {info[1]};
-  info.GetReturnValue().Set(getOwn->Call(obj, 1, argv));
+  info.GetReturnValue().Set(
+    record->Trap(kTrapGetOwnPropertyDescriptor)->Call(obj, 1, argv));
 }
 
 /**
@@ -583,22 +3276,22 @@ NAN_METHOD(NodeProxy::DefineProperty) {
   Local<String> name = info[1]->ToString();
   Local<Object> handler = temp->ToObject();
 
-  if (handler->GetHiddenValue(Nan::New<String>("sealed").ToLocalChecked())->BooleanValue() ||
-  !handler->Has(Nan::New<String>("defineProperty").ToLocalChecked())) {
+  if ((GetState(obj) & kStateSealed) ||
+  !handler->Has(Key(kKeyDefineProperty))) {
     info.GetReturnValue().Set(Nan::False());
     return;
   }
 
-  if (!handler->GetHiddenValue(Nan::New<String>("extensible").ToLocalChecked())->BooleanValue() &&
+  if (!(GetState(obj) & kStateExtensible) &&
         !handler->Has(name)) {
     info.GetReturnValue().Set(Nan::False());
     return;
   }
 
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+  if (!(GetState(obj) & kStateTrapping)) {
     Local<Object> desc = handler->Get(name)->ToObject();
 
-    if (desc->Get(Nan::New<String>("configurable").ToLocalChecked())->BooleanValue()) {
+    if (desc->Get(Key(kKeyConfigurable))->BooleanValue()) {
       info.GetReturnValue().Set(Nan::New<Boolean>(
           handler->Set(name, info[2]->ToObject())));
       return;
@@ -607,10 +3300,17 @@ NAN_METHOD(NodeProxy::DefineProperty) {
     return;
   }
 
-  Local<Function> def = Local<Function>::Cast(
-                  handler->Get(Nan::New<String>("defineProperty").ToLocalChecked()));
+  HandlerRecord *record = HandlerRecord::From(obj);
+
+  if (record == NULL || !record->HasTrap(kTrapDefineProperty)) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  Local<Function> def = record->Trap(kTrapDefineProperty);
 
   Local<Value> argv[2] = {info[1], info[2]->ToObject()};
+  Invalidate(obj, name);
 
   info.GetReturnValue().Set(def->Call(obj, 2, argv)->ToBoolean());
 }
@@ -651,17 +3351,16 @@ NAN_METHOD(NodeProxy::DefineProperties) {
     Local<Object> props = info[1]->ToObject();
     Local<Object> handler = temp->ToObject();
 
-    if (handler->GetHiddenValue(Nan::New<String>("sealed").ToLocalChecked())->BooleanValue()) {
+    if (GetState(obj) & kStateSealed) {
       info.GetReturnValue().Set(Nan::False());
       return;
     }
 
-    bool extensible = handler->GetHiddenValue(
-                  Nan::New<String>("extensible").ToLocalChecked())->BooleanValue();
+    bool extensible = (GetState(obj) & kStateExtensible) != 0;
     Local<Array> names = props->GetPropertyNames();
     uint32_t i = 0, l = names->Length();
 
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(obj) & kStateTrapping)) {
       for (;i < l; ++i) {
         Local<Object> name = names->CloneElementAt(i);
 
@@ -670,7 +3369,7 @@ NAN_METHOD(NodeProxy::DefineProperties) {
         ) {
           Local<Object> tempObj =         handler->Get(name->ToString())->ToObject();
 
-          if (tempObj->Get(Nan::New<String>("configurable").ToLocalChecked())->BooleanValue()) {
+          if (tempObj->Get(Key(kKeyConfigurable))->BooleanValue()) {
             if (!handler->Set(name->ToString(),
                       props->Get(name->ToString()))) {
               Nan::ThrowError(
@@ -691,7 +3390,14 @@ NAN_METHOD(NodeProxy::DefineProperties) {
       return;
     }
 
-    Local<Function> def =   Local<Function>::Cast(handler->Get(Nan::New<String>("defineProperty").ToLocalChecked()));
+    HandlerRecord *record = HandlerRecord::From(obj);
+
+    if (record == NULL || !record->HasTrap(kTrapDefineProperty)) {
+      info.GetReturnValue().Set(Nan::False());
+      return;
+    }
+
+    Local<Function> def = record->Trap(kTrapDefineProperty);
 
     TryCatch firstTry;
     for (;i < l; ++i) {
@@ -700,6 +3406,7 @@ NAN_METHOD(NodeProxy::DefineProperties) {
       if (extensible || obj->Has(name->ToString())) {
         Local<Value> pd = props->Get(name->ToString());
         Local<Value> argv[2] = {name, pd};
+        Invalidate(obj, name->ToString());
         def->Call(obj, 2, argv);
 
         if (firstTry.HasCaught()) {
@@ -725,43 +3432,52 @@ NAN_METHOD(NodeProxy::DefineProperties) {
  */
 NAN_METHOD(NodeProxy::New) {
 
-  if (info.Callee()->InternalFieldCount() < 1 && info.Data().IsEmpty()) {
-    Nan::ThrowTypeError("defineProperty expects first "
-                "argument to be intialized by Proxy");
-    return;
-  }
-
-  Local<Value> v, ret, data =  info.Holder()->GetInternalField(0);
+  Local<Object> holder = info.Holder();
 
-  if (data.IsEmpty() || !data->IsObject()) {
-    Nan::ThrowError("Invalid reference to Proxy#constructor");
+  if (holder->InternalFieldCount() < kFunctionFieldCount) {
+    Nan::ThrowTypeError("Invalid reference to Proxy#constructor");
     return;
   }
 
-  Local<Function> fn;
-  Local<Object> obj = data->ToObject();
+  TrapScope trap_scope(holder, info.IsConstructCall() ?
+                               kInterceptConstruct : kInterceptCall);
+
+  Local<Value> trap, ret;
 
   if (info.IsConstructCall()) {
-    v = obj->GetHiddenValue(Nan::New<String>("constructorTrap").ToLocalChecked());
+    trap = holder->GetInternalField(kConstructorTrapField);
 
-    if (!v.IsEmpty() && v->IsFunction()) {
-      fn = Local<Function>::Cast(v);
-    } else {
-      fn = Local<Function>::Cast(
-          obj->GetHiddenValue(Nan::New<String>("callTrap").ToLocalChecked()));
+    if (trap.IsEmpty() || !trap->IsFunction()) {
+      trap = holder->GetInternalField(kCallTrapField);
     }
   } else {
-    fn = Local<Function>::Cast(obj->GetHiddenValue(Nan::New<String>("callTrap").ToLocalChecked()));
+    trap = holder->GetInternalField(kCallTrapField);
   }
 
+  if (trap.IsEmpty() || !trap->IsFunction()) {
+    Nan::ThrowError("Invalid reference to Proxy#constructor");
+    return;
+  }
+
+  Local<Function> fn = Local<Function>::Cast(trap);
+
+  // forward the arguments from the stack, only
+  // unusually long argument lists touch the heap
   int i = 0, l = info.Length();
-  Local<Value>* argv = new Local<Value>[l];
+  Local<Value> stackArgv[kStackArgumentCount];
+  std::vector<Local<Value> > heapArgv;
+  Local<Value>* argv = stackArgv;
+
+  if (l > kStackArgumentCount) {
+    heapArgv.resize(l);
+    argv = &heapArgv[0];
+  }
 
   for (; i < l; ++i) {
     argv[i] = info[i];
   }
 
-  ret = fn->Call(info.This(), info.Length(), argv);
+  ret = fn->Call(info.This(), l, argv);
 
   if (info.IsConstructCall()) {
     if (!ret.IsEmpty()) {
@@ -782,12 +3498,34 @@ NAN_METHOD(NodeProxy::New) {
  */
 NAN_PROPERTY_GETTER(NodeProxy::GetNamedProperty) {
 
-  if (info.This()->InternalFieldCount() < 1 || info.Data().IsEmpty()) {
+  if (info.This()->InternalFieldCount() < kProxyFieldCount || info.Data().IsEmpty()) {
     Nan::ThrowTypeError("SetNamedProperty intercepted "
                 "by non-Proxy object");
     return;
   }
 
+  ProxyExtension *structure = Structured(info.This());
+
+  if (structure != NULL) {
+    const StructLayout::Field *field = structure->layout->Find(PropertyName(property));
+
+    if (field != NULL) {
+      info.GetReturnValue().Set(ReadField(structure, *field));
+      return;
+    }
+
+    // without a handler, the other names behave as on a plain object
+    if (!structure->trapsUnknown) {
+      return;
+    }
+  }
+
+  if (Bypasses(info.This(), property)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptGet, property);
+
   Local<Value> argv1[1] = {property};
   Local<Value> data = info.This()->InternalFieldCount() > 0 ?
                       info.This()->GetInternalField(0) :
@@ -803,33 +3541,91 @@ NAN_PROPERTY_GETTER(NodeProxy::GetNamedProperty) {
 
   // if the Proxy isn't trapping, return
   // the value set on the property descriptor
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+  if (!(GetState(info.This()) & kStateTrapping)) {
     info.GetReturnValue().Set(CallPropertyDescriptorGet(handler->Get(property), info.This(), argv1));
     return;
   }
 
-  Local<Value> get = handler->Get(Nan::New<String>("get").ToLocalChecked());
-  if (get->IsFunction()) {
-    fn = Local<Function>::Cast(get);
-    Local<Value> argv[2] = {info.This(), property};
+  HandlerRecord *record = HandlerRecord::From(info.This());
+
+  if (record == NULL) {
+    info.GetReturnValue().SetUndefined();
+    return;
+  }
+
+  if (record->hotKeys != NULL) {
+    record->hotKeys->Add(PropertyName(property));
+  }
+
+  Local<Value> length;
 
-    info.GetReturnValue().Set(fn->Call(handler, 2, argv));
+  if (ArrayLength(info.This(), record, property, &length)) {
+    if (!length.IsEmpty()) {
+      info.GetReturnValue().Set(length);
+    }
     return;
   }
 
-  Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-  if (getPropertyDescriptor->IsFunction()) {
-    fn = Local<Function>::Cast(getPropertyDescriptor);
+  ProxyExtension *caching = Caching(info.This());
+  Local<Value> cached;
 
-    info.GetReturnValue().Set(CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1));
+  if (caching != NULL && caching->Recall(PropertyName(property), &cached)) {
+    info.GetReturnValue().Set(cached);
     return;
   }
 
-  Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-  if (getOwnPropertyDescriptor->IsFunction()) {
-    fn = Local<Function>::Cast(getOwnPropertyDescriptor);
+  switch (record->get) {
+    case kGetPathGet: {
+      Local<Value> argv[2] = {info.This(), property};
+      Local<Value> result = record->Trap(kTrapGet)->Call(handler, 2, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(Remember(caching, property, result));
+        return;
+      }
+      break;
+    }
+
+    case kGetPathValue: {
+      Local<Value> result = record->Trap(kTrapGetValue)->Call(handler, 1, argv1);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(Remember(caching, property, result));
+        return;
+      }
+      break;
+    }
+
+    case kGetPathPropertyDescriptor:
+      fn = record->Trap(kTrapGetPropertyDescriptor);
+
+      info.GetReturnValue().Set(Remember(caching, property,
+          CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1)));
+      return;
+
+    case kGetPathOwnPropertyDescriptor:
+      fn = record->Trap(kTrapGetOwnPropertyDescriptor);
+
+      info.GetReturnValue().Set(Remember(caching, property,
+          CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1)));
+      return;
+
+    default:
+      break;
+  }
+
+  Local<Object> target = ForwardTarget(info.This());
 
-    info.GetReturnValue().Set(CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1));
+  if (!target.IsEmpty()) {
+    info.GetReturnValue().Set(target->Get(property));
     return;
   }
   info.GetReturnValue().SetUndefined(); // <-- silence warnings for 0.10.x
@@ -837,15 +3633,21 @@ NAN_PROPERTY_GETTER(NodeProxy::GetNamedProperty) {
 
 NAN_INLINE Local<Value> NodeProxy::CallPropertyDescriptorGet(Local<Value> descriptor, Handle<Object> context, Local<Value> info[1]) {
   Nan::EscapableHandleScope scope;
+
+  // the descriptor trap threw, leave its exception pending
+  if (descriptor.IsEmpty()) {
+    return Local<Value>();
+  }
+
   if (descriptor->IsObject()) {
-    Local<Value> get = descriptor->ToObject()->Get(Nan::New<String>("get").ToLocalChecked());
+    Local<Value> get = descriptor->ToObject()->Get(Key(kKeyGet));
 
     if (get->IsFunction()) {
       Local<Function> fn = Local<Function>::Cast(get);
       return fn->Call(context, 1, info);
     }
 
-    return descriptor->ToObject()->Get(Nan::New<String>("value").ToLocalChecked());
+    return descriptor->ToObject()->Get(Key(kKeyValue));
   }
 
   return scope.Escape(Nan::Undefined());
@@ -859,12 +3661,38 @@ NAN_INLINE Local<Value> NodeProxy::CallPropertyDescriptorGet(Local<Value> descri
  */
 NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
 
-  if (info.This()->InternalFieldCount() < 1 || info.Data().IsEmpty()) {
+  if (info.This()->InternalFieldCount() < kProxyFieldCount || info.Data().IsEmpty()) {
     Nan::ThrowTypeError("SetNamedProperty intercepted "
                 "by non-Proxy object");
     return;
   }
 
+  ProxyExtension *structure = Structured(info.This());
+
+  if (structure != NULL) {
+    const StructLayout::Field *field = structure->layout->Find(PropertyName(property));
+
+    if (field != NULL) {
+      if (!(GetState(info.This()) & kStateFrozen)) {
+        WriteField(structure, *field, value);
+      }
+
+      info.GetReturnValue().Set(value);
+      return;
+    }
+
+    if (!structure->trapsUnknown) {
+      return;
+    }
+  }
+
+  if (Bypasses(info.This(), property)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptSet, property);
+  Invalidate(info.This(), property);
+
   Local<Value> argv2[2] = {property, value};
   Local<Value> data = info.This()->InternalFieldCount() > 0 ?
                       info.This()->GetInternalField(0) :
@@ -879,8 +3707,8 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
 
   // if the Proxy isn't trapping, return the
   // value set on the property descriptor
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
-    if (handler->GetHiddenValue(Nan::New<String>("extensible").ToLocalChecked())->BooleanValue() ||
+  if (!(GetState(info.This()) & kStateTrapping)) {
+    if ((GetState(info.This()) & kStateExtensible) ||
       handler->Has(property)
     ) {
       Local<Value> pd = handler->Get(property);
@@ -893,7 +3721,7 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
       Local<Object> pd_obj = pd->ToObject();
 
       if (!pd_obj->GetHiddenValue(
-            Nan::New<String>("writable").ToLocalChecked())->BooleanValue()
+            Key(kKeyWritable))->BooleanValue()
       ) {
         Nan::ThrowError(
               String::Concat(
@@ -902,7 +3730,7 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
         return;
       }
 
-      Local<Value> set = pd_obj->Get(Nan::New<String>("set").ToLocalChecked());
+      Local<Value> set = pd_obj->Get(Key(kKeySet));
       if (set->IsFunction()) {
         Local<Function> fn = Local<Function>::Cast(set);
         fn->Call(info.This(), 2, argv2);
@@ -911,7 +3739,7 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
         return;
       }
 
-      if (pd_obj->Set(Nan::New<String>("value").ToLocalChecked(), value)) {
+      if (pd_obj->Set(Key(kKeyValue), value)) {
         info.GetReturnValue().Set(value);
         return;
       }
@@ -922,30 +3750,79 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
     return;
   }
 
-  // does the ProxyHandler have a set method?
-  Local<Value> set = handler->Get(Nan::New<String>("set").ToLocalChecked());
-  if (set->IsFunction()) {
-    Local<Function> set_fn = Local<Function>::Cast(set);
-    Local<Value> argv3[3] = {info.This(), property, value};
-    set_fn->Call(handler, 3, argv3);
+  HandlerRecord *record = HandlerRecord::From(info.This());
 
-    info.GetReturnValue().Set(value);
+  if (record == NULL) {
+    info.GetReturnValue().SetUndefined();
     return;
   }
 
-  Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-  if (getOwnPropertyDescriptor->IsFunction()) {
-    Local<Function> gopd_fn = Local<Function>::Cast(getOwnPropertyDescriptor);
-    Local<Value> argv[1] = {property};
-    info.GetReturnValue().Set(CallPropertyDescriptorSet(gopd_fn->Call(handler, 1, argv), info.This(), property, value));
-    return;
+  if (record->hotKeys != NULL) {
+    record->hotKeys->Add(PropertyName(property));
   }
 
-  Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-  if (getPropertyDescriptor->IsFunction()) {
-    Local<Function> gpd_fn = Local<Function>::Cast(getPropertyDescriptor);
-    Local<Value> argv[1] = {property};
-    info.GetReturnValue().Set(CallPropertyDescriptorSet(gpd_fn->Call(handler, 1, argv), info.This(), property, value));
+  switch (record->set) {
+    // does the ProxyHandler have a set method?
+    case kSetPathSet: {
+      Local<Value> argv3[3] = {info.This(), property, value};
+      Local<Value> result = record->Trap(kTrapSet)->Call(handler, 3, argv3);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(value);
+        return;
+      }
+      break;
+    }
+
+    case kSetPathValue: {
+      Local<Value> result = record->Trap(kTrapSetValue)->Call(handler, 2, argv2);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(value);
+        return;
+      }
+      break;
+    }
+
+    case kSetPathOwnPropertyDescriptor: {
+      Local<Function> gopd_fn = record->Trap(kTrapGetOwnPropertyDescriptor);
+      Local<Value> argv[1] = {property};
+      Local<Value> result = CallPropertyDescriptorSet(gopd_fn->Call(handler, 1, argv), info.This(), property, value);
+
+      if (!result.IsEmpty()) {
+        info.GetReturnValue().Set(result);
+      }
+      return;
+    }
+
+    case kSetPathPropertyDescriptor: {
+      Local<Function> gpd_fn = record->Trap(kTrapGetPropertyDescriptor);
+      Local<Value> argv[1] = {property};
+      Local<Value> result = CallPropertyDescriptorSet(gpd_fn->Call(handler, 1, argv), info.This(), property, value);
+
+      if (!result.IsEmpty()) {
+        info.GetReturnValue().Set(result);
+      }
+      return;
+    }
+
+    default:
+      break;
+  }
+
+  Local<Object> target = ForwardTarget(info.This());
+
+  if (!target.IsEmpty()) {
+    target->Set(property, value);
+    info.GetReturnValue().Set(value);
     return;
   }
 
@@ -953,18 +3830,38 @@ NAN_PROPERTY_SETTER(NodeProxy::SetNamedProperty) {
 }
 
 NAN_INLINE Local<Value> NodeProxy::CallPropertyDescriptorSet(Local<Value> descriptor, Handle<Object> context, Local<Value> name, Local<Value> value) {
+  // an empty descriptor means the trap threw
+  if (descriptor.IsEmpty()) {
+    return Local<Value>();
+  }
+
   Nan::EscapableHandleScope scope;
   if (descriptor->IsObject()) {
     Local<Object> pd = descriptor->ToObject();
-    Local<Value> set = pd->Get(Nan::New<String>("set").ToLocalChecked());
+    Local<Value> set = pd->Get(Key(kKeySet));
+
+    if (set.IsEmpty()) {
+      return Local<Value>();
+    }
+
+    if (set->IsFunction()) {
+      Local<Function> fn = Local<Function>::Cast(set);
+      Local<Value> info[2] = { name, value };
+      Local<Value> result = fn->Call(context, 2, info);
+
+      if (result.IsEmpty()) {
+        return Local<Value>();
+      }
+
+      return scope.Escape(result);
+    }
 
-    if (set->IsFunction()) {
-      Local<Function> fn = Local<Function>::Cast(set);
-      Local<Value> info[2] = { name, value };
-      return fn->Call(context, 2, info);
+    Local<Value> writable = pd->Get(Key(kKeyWritable));
 
-    } else if (pd->Get(Nan::New<String>("writable").ToLocalChecked())->BooleanValue()) {
-      if (pd->Set(Nan::New<String>("value").ToLocalChecked(), value)) {
+    if (writable.IsEmpty()) {
+      return Local<Value>();
+    } else if (writable->BooleanValue()) {
+      if (pd->Set(Key(kKeyValue), value)) {
         return value;
       }
     }
@@ -984,6 +3881,25 @@ NAN_PROPERTY_QUERY(NodeProxy::QueryNamedPropertyInteger) {
 
   Local<Integer> DoesntHavePropertyResponse;
   Local<Integer> HasPropertyResponse = Nan::New<Integer>(None);
+  ProxyExtension *structure = Structured(info.This());
+
+  if (structure != NULL) {
+    if (structure->layout->Find(PropertyName(property)) != NULL) {
+      info.GetReturnValue().Set(Nan::New<Integer>(DontDelete));
+      return;
+    }
+
+    if (!structure->trapsUnknown) {
+      return;
+    }
+  }
+
+  if (info.This()->InternalFieldCount() >= kProxyFieldCount &&
+      Bypasses(info.This(), property)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptQuery, property);
 
   if (info.This()->InternalFieldCount() > 0 || !info.Data().IsEmpty()) {
     Local<Value> data = info.This()->InternalFieldCount() > 0 ?
@@ -999,7 +3915,7 @@ NAN_PROPERTY_QUERY(NodeProxy::QueryNamedPropertyInteger) {
 
     // if the Proxy isn't trapping,
     // return the value set on the property descriptor
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(info.This()) & kStateTrapping)) {
       if (handler->Has(property)) {
         Local<Value> pd = handler->Get(property);
 
@@ -1016,48 +3932,87 @@ NAN_PROPERTY_QUERY(NodeProxy::QueryNamedPropertyInteger) {
 
     Local<Value> argv[1] = {property};
 
-    Local<Value> hasOwn = handler->Get(Nan::New<String>("hasOwn").ToLocalChecked());
-    if (hasOwn->IsFunction()) {
-      Local<Function> hasOwn_fn = Local<Function>::Cast(hasOwn);
-      info.GetReturnValue().Set(hasOwn_fn->Call(handler, 1, argv)->BooleanValue() ?
-                     HasPropertyResponse :
-                     DoesntHavePropertyResponse);
+    HandlerRecord *record = HandlerRecord::From(info.This());
+
+    if (record == NULL) {
+      info.GetReturnValue().Set(DoesntHavePropertyResponse);
       return;
     }
 
-    Local<Value> has = handler->Get(Nan::New<String>("has").ToLocalChecked());
-    if (has->IsFunction()) {
-      Local<Function> has_fn = Local<Function>::Cast(has);
-      info.GetReturnValue().Set(has_fn->Call(handler, 1, argv)->BooleanValue() ?
-                     HasPropertyResponse :
-                     DoesntHavePropertyResponse);
+    ProxyExtension *caching = Caching(info.This(), kStateCachingQueries);
+    int32_t cached;
+
+    if (caching != NULL && caching->attributes->Find(PropertyName(property), &cached)) {
+      if (cached != AttributeCache::kAbsent) {
+        info.GetReturnValue().Set(Nan::New<Integer>(cached));
+      }
       return;
     }
 
-    Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-    if (getOwnPropertyDescriptor->IsFunction()) {
-      Local<Function> gopd_fn = Local<Function>::Cast(getOwnPropertyDescriptor);
+    if (record->query == kQueryPathHasOwn || record->query == kQueryPathHas) {
+      Local<Function> fn = record->Trap(record->query == kQueryPathHasOwn ?
+                                        kTrapHasOwn : kTrapHas);
+      Local<Value> result = fn->Call(handler, 1, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(RememberQuery(caching, property,
+                       result->BooleanValue() ?
+                       HasPropertyResponse :
+                       DoesntHavePropertyResponse));
+        return;
+      }
+    } else if (record->HasTrap(kTrapGetOwnPropertyDescriptor)) {
+      Local<Function> gopd_fn = record->Trap(kTrapGetOwnPropertyDescriptor);
       Local<Value> gopd_pd = gopd_fn->Call(handler, 1, argv);
 
+      if (gopd_pd.IsEmpty()) {
+        return;
+      }
+
       if (gopd_pd->IsObject()) {
-        info.GetReturnValue().Set(GetPropertyAttributeFromPropertyDescriptor(gopd_pd->ToObject()));
+        info.GetReturnValue().Set(RememberQuery(caching, property,
+            GetPropertyAttributeFromPropertyDescriptor(gopd_pd->ToObject())));
         return;
       }
     }
 
-    Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-    if (handler->Has(Nan::New<String>("getPropertyDescriptor").ToLocalChecked())) {
-      Local<Function> gpd_fn = Local<Function>::Cast(getPropertyDescriptor);
+    if (record->query == kQueryPathDescriptor &&
+        record->HasTrap(kTrapGetPropertyDescriptor)) {
+      Local<Function> gpd_fn = record->Trap(kTrapGetPropertyDescriptor);
       Local<Value> gpd_pd = gpd_fn->Call(handler, 1, argv);
 
+      if (gpd_pd.IsEmpty()) {
+        return;
+      }
+
       if (gpd_pd->IsObject()) {
-        info.GetReturnValue().Set(GetPropertyAttributeFromPropertyDescriptor(gpd_pd->ToObject()));
+        info.GetReturnValue().Set(RememberQuery(caching, property,
+            GetPropertyAttributeFromPropertyDescriptor(gpd_pd->ToObject())));
         return;
       } else if (gpd_pd->IsUndefined()) {
-        info.GetReturnValue().Set(DoesntHavePropertyResponse);
+        info.GetReturnValue().Set(RememberQuery(caching, property,
+            DoesntHavePropertyResponse));
         return;
       }
     }
+
+    Local<Object> target = ForwardTarget(info.This());
+
+    if (!target.IsEmpty()) {
+      info.GetReturnValue().Set(target->Has(property) ?
+                     HasPropertyResponse :
+                     DoesntHavePropertyResponse);
+      return;
+    }
+
+    // no trap reported the property
+    info.GetReturnValue().Set(RememberQuery(caching, property,
+        DoesntHavePropertyResponse));
+    return;
   }
 
   info.GetReturnValue().Set(DoesntHavePropertyResponse);
@@ -1072,22 +4027,20 @@ NAN_PROPERTY_QUERY(NodeProxy::QueryNamedPropertyInteger) {
 Local<Integer>
 NodeProxy::GetPropertyAttributeFromPropertyDescriptor(Local<Object> pd) {
   uint32_t ret = None;
+  Local<Value> configurable = pd->Get(Key(kKeyConfigurable));
+  Local<Value> enumerable = pd->Get(Key(kKeyEnumerable));
+  Local<Value> writable = pd->Get(Key(kKeyWritable));
 
-  if (pd->Get(Nan::New<String>("configurable").ToLocalChecked())->IsBoolean() &&
-        !pd->Get(Nan::New<String>("configurable").ToLocalChecked())->BooleanValue()) {
-    ret &= DontDelete;
+  if (!configurable.IsEmpty() && configurable->IsBoolean() && !configurable->BooleanValue()) {
+    ret |= DontDelete;
   }
 
-  if (pd->Get(Nan::New<String>("enumerable").ToLocalChecked())->IsBoolean() &&
-             !pd->Get(Nan::New<String>("enumerable").ToLocalChecked())->BooleanValue()) {
-    // return Nan::New<Integer>(DontEnum);
-    ret &= DontEnum;
+  if (!enumerable.IsEmpty() && enumerable->IsBoolean() && !enumerable->BooleanValue()) {
+    ret |= DontEnum;
   }
 
-  if (pd->Get(Nan::New<String>("writable").ToLocalChecked())->IsBoolean() &&
-             !pd->Get(Nan::New<String>("writable").ToLocalChecked())->BooleanValue()) {
-     // return Nan::New<Integer>(ReadOnly);
-     ret &= ReadOnly;
+  if (!writable.IsEmpty() && writable->IsBoolean() && !writable->BooleanValue()) {
+    ret |= ReadOnly;
   }
 
   return Nan::New<Integer>(ret);
@@ -1101,6 +4054,28 @@ NodeProxy::GetPropertyAttributeFromPropertyDescriptor(Local<Object> pd) {
  */
 NAN_PROPERTY_DELETER(NodeProxy::DeleteNamedProperty) {
 
+  ProxyExtension *structure = Structured(info.This());
+
+  // the fields of a struct cannot be deleted
+  if (structure != NULL) {
+    if (structure->layout->Find(PropertyName(property)) != NULL) {
+      info.GetReturnValue().Set(Nan::False());
+      return;
+    }
+
+    if (!structure->trapsUnknown) {
+      return;
+    }
+  }
+
+  if (info.This()->InternalFieldCount() >= kProxyFieldCount &&
+      Bypasses(info.This(), property)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptDelete, property);
+  Invalidate(info.This(), property);
+
   if (info.This()->InternalFieldCount() > 0 || !info.Data().IsEmpty()) {
     Local<Value> data = info.This()->InternalFieldCount() > 0 ?
                  info.This()->GetInternalField(0) :
@@ -1114,15 +4089,15 @@ NAN_PROPERTY_DELETER(NodeProxy::DeleteNamedProperty) {
     Local<Object> handler = data->ToObject();
     // if the Proxy isn't trapping,
     // return the value set on the property descriptor
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
-      if (!handler->GetHiddenValue(Nan::New<String>("frozen").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(info.This()) & kStateTrapping)) {
+      if (!(GetState(info.This()) & kStateFrozen)) {
         Local<Value> pd = handler->Get(property);
 
         if (pd->IsObject()) {
           Local<Object> pd_obj = pd->ToObject();
 
-          if (pd_obj->Get(Nan::New<String>("configurable").ToLocalChecked())->IsBoolean() &&
-              pd_obj->Get(Nan::New<String>("configurable").ToLocalChecked())->BooleanValue()
+          if (pd_obj->Get(Key(kKeyConfigurable))->IsBoolean() &&
+              pd_obj->Get(Key(kKeyConfigurable))->BooleanValue()
           ) {
             info.GetReturnValue().Set(Nan::New<Boolean>(handler->Delete(property)));
             return;
@@ -1133,11 +4108,27 @@ NAN_PROPERTY_DELETER(NodeProxy::DeleteNamedProperty) {
       return;
     }
 
-    Local<Value> delete_ = handler->Get(Nan::New<String>("delete").ToLocalChecked());
-    if (delete_->IsFunction()) {
-      Local<Function> fn = Local<Function>::Cast(delete_);
+    HandlerRecord *record = HandlerRecord::From(info.This());
+
+    if (record != NULL && record->HasTrap(kTrapDelete)) {
+      Local<Function> fn = record->Trap(kTrapDelete);
       Local<Value> argv[1] = {property};
-      info.GetReturnValue().Set(fn->Call(handler, 1, argv)->ToBoolean());
+      Local<Value> result = fn->Call(handler, 1, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(result->ToBoolean());
+        return;
+      }
+    }
+
+    Local<Object> target = ForwardTarget(info.This());
+
+    if (!target.IsEmpty()) {
+      info.GetReturnValue().Set(Nan::New<Boolean>(target->Delete(property)));
       return;
     }
   }
@@ -1153,6 +4144,19 @@ NAN_PROPERTY_DELETER(NodeProxy::DeleteNamedProperty) {
  */
 NAN_PROPERTY_ENUMERATOR(NodeProxy::EnumerateNamedProperties) {
 
+  TrapScope trap_scope(info.This(), kInterceptEnumerate);
+
+  ProxyExtension *structure = Structured(info.This());
+
+  if (structure != NULL) {
+    Local<Array> names = StructNames(structure, info.This());
+
+    if (!names.IsEmpty()) {
+      info.GetReturnValue().Set(names);
+    }
+    return;
+  }
+
   if (info.This()->InternalFieldCount() > 0 || !info.Data().IsEmpty()) {
     Local<Value> data = info.This()->InternalFieldCount() > 0 ?
         info.This()->GetInternalField(0) :
@@ -1173,42 +4177,68 @@ NAN_PROPERTY_ENUMERATOR(NodeProxy::EnumerateNamedProperties) {
 
     // if the Proxy isn't trapping,
     // return the value set on the property descriptor
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(info.This()) & kStateTrapping)) {
       info.GetReturnValue().Set(handler->GetPropertyNames());
       return;
     }
 
-    Local<Value> enumerate = handler->Get(Nan::New<String>("enumerate").ToLocalChecked());
-    if (enumerate->IsFunction()) {
-      Local<Function> enumerate_fn = Local<Function>::Cast(enumerate);
-      Local<Value> names = enumerate_fn->Call(handler, 0, argv);
+    HandlerRecord *record = HandlerRecord::From(info.This());
+
+    if (record == NULL || (record->enumerate == kEnumeratePathNone &&
+                           !(GetState(info.This()) & kStateForwarding))) {
+      info.GetReturnValue().Set(Nan::New<Array>());
+      return;
+    }
+
+    // fall through to the next trap when one does not
+    // produce an Array or an iterator, @see NodeProxy::CollectNames
+    if (record->enumerate == kEnumeratePathEnumerate) {
+      Local<Function> enumerate_fn = record->Trap(kTrapEnumerate);
+      Local<Array> names;
+
+      if (!CollectNames(enumerate_fn->Call(handler, 0, argv), &names)) {
+        return;
+      }
 
-      if (names->IsArray()) {
-        info.GetReturnValue().Set(Local<Array>::Cast(names->ToObject()));
+      if (!names.IsEmpty()) {
+        info.GetReturnValue().Set(names);
         return;
       }
     }
 
-    Local<Value> keys = handler->Get(Nan::New<String>("keys").ToLocalChecked());
-    if (keys->IsFunction()) {
-      Local<Function> keys_fn = Local<Function>::Cast(enumerate);
-      Local<Value> names = keys_fn->Call(handler, 0, argv);
+    if (record->HasTrap(kTrapKeys)) {
+      Local<Function> keys_fn = record->Trap(kTrapKeys);
+      Local<Array> names;
+
+      if (!CollectNames(keys_fn->Call(handler, 0, argv), &names)) {
+        return;
+      }
 
-      if (names->IsArray()) {
-        info.GetReturnValue().Set(Local<Array>::Cast(names->ToObject()));
+      if (!names.IsEmpty()) {
+        info.GetReturnValue().Set(names);
         return;
       }
     }
 
-    Local<Value> getPropertyNames = handler->Get(Nan::New<String>("getPropertyNames").ToLocalChecked());
-    if (getPropertyNames->IsFunction()) {
-      Local<Function> gpn_fn = Local<Function>::Cast(getPropertyNames);
-      Local<Value> names = gpn_fn->Call(handler, 0, argv);
+    if (record->HasTrap(kTrapGetPropertyNames)) {
+      Local<Function> gpn_fn = record->Trap(kTrapGetPropertyNames);
+      Local<Array> names;
 
-      if (names->IsArray()) {
-        info.GetReturnValue().Set(Local<Array>::Cast(names->ToObject()));
+      if (!CollectNames(gpn_fn->Call(handler, 0, argv), &names)) {
         return;
       }
+
+      if (!names.IsEmpty()) {
+        info.GetReturnValue().Set(names);
+        return;
+      }
+    }
+
+    Local<Object> target = ForwardTarget(info.This());
+
+    if (!target.IsEmpty()) {
+      info.GetReturnValue().Set(target->GetPropertyNames());
+      return;
     }
   }
 
@@ -1223,12 +4253,26 @@ NAN_PROPERTY_ENUMERATOR(NodeProxy::EnumerateNamedProperties) {
  */
 NAN_INDEX_GETTER(NodeProxy::GetIndexedProperty) {
 
-  if (info.This()->InternalFieldCount() < 1 || info.Data().IsEmpty()) {
+  if (info.This()->InternalFieldCount() < kProxyFieldCount || info.Data().IsEmpty()) {
     Nan::ThrowTypeError("SetNamedProperty intercepted "
                 "by non-Proxy object");
     return;
   }
 
+  ProxyExtension *view = Viewing(info.This());
+  double element;
+
+  if (view != NULL && view->GetElement(index, &element)) {
+    info.GetReturnValue().Set(Nan::New<Number>(element));
+    return;
+  }
+
+  if (Bypasses(info.This(), index)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptGet, index);
+
   Local<Integer> idx = Nan::New<Integer>(index);
   Local<Value> argv1[1] = {idx};
   Local<Value> data = info.This()->InternalFieldCount() > 0 ?
@@ -1245,33 +4289,78 @@ NAN_INDEX_GETTER(NodeProxy::GetIndexedProperty) {
 
   // if the Proxy isn't trapping, return
   // the value set on the index descriptor
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+  if (!(GetState(info.This()) & kStateTrapping)) {
     info.GetReturnValue().Set(CallPropertyDescriptorGet(handler->Get(idx), info.This(), argv1));
     return;
   }
 
-  Local<Value> get = handler->Get(Nan::New<String>("get").ToLocalChecked());
-  if (get->IsFunction()) {
-    fn = Local<Function>::Cast(get);
-    Local<Value> argv[2] = {info.This(), idx};
+  HandlerRecord *record = HandlerRecord::From(info.This());
 
-    info.GetReturnValue().Set(fn->Call(handler, 2, argv));
+  if (record == NULL) {
+    info.GetReturnValue().SetUndefined();
     return;
   }
 
-  Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-  if (getPropertyDescriptor->IsFunction()) {
-    fn = Local<Function>::Cast(getPropertyDescriptor);
+  ProxyExtension *caching = Caching(info.This());
+  Local<Value> cached;
 
-    info.GetReturnValue().Set(CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1));
+  if (caching != NULL && caching->Recall(PropertyName(index), &cached)) {
+    info.GetReturnValue().Set(cached);
     return;
   }
 
-  Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-  if (getOwnPropertyDescriptor->IsFunction()) {
-    fn = Local<Function>::Cast(getOwnPropertyDescriptor);
+  switch (record->get) {
+    case kGetPathGet: {
+      Local<Value> argv[2] = {info.This(), idx};
+      Local<Value> result = record->Trap(kTrapGet)->Call(handler, 2, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(Remember(caching, index, result));
+        return;
+      }
+      break;
+    }
+
+    case kGetPathValue: {
+      Local<Value> result = record->Trap(kTrapGetValue)->Call(handler, 1, argv1);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(Remember(caching, index, result));
+        return;
+      }
+      break;
+    }
+
+    case kGetPathPropertyDescriptor:
+      fn = record->Trap(kTrapGetPropertyDescriptor);
+
+      info.GetReturnValue().Set(Remember(caching, index,
+          CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1)));
+      return;
+
+    case kGetPathOwnPropertyDescriptor:
+      fn = record->Trap(kTrapGetOwnPropertyDescriptor);
+
+      info.GetReturnValue().Set(Remember(caching, index,
+          CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1)));
+      return;
+
+    default:
+      break;
+  }
+
+  Local<Object> target = ForwardTarget(info.This());
 
-    info.GetReturnValue().Set(CallPropertyDescriptorGet(fn->Call(handler, 1, argv1), info.This(), argv1));
+  if (!target.IsEmpty()) {
+    info.GetReturnValue().Set(target->Get(index));
     return;
   }
   info.GetReturnValue().SetUndefined(); // <-- silence warnings for 0.10.x
@@ -1285,12 +4374,30 @@ NAN_INDEX_GETTER(NodeProxy::GetIndexedProperty) {
  */
 NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
 
-  if (info.This()->InternalFieldCount() < 1 || info.Data().IsEmpty()) {
+  if (info.This()->InternalFieldCount() < kProxyFieldCount || info.Data().IsEmpty()) {
     Nan::ThrowTypeError("SetNamedProperty intercepted "
                 "by non-Proxy object");
     return;
   }
 
+  ProxyExtension *view = Viewing(info.This());
+
+  if (view != NULL && index < view->ElementCount()) {
+    if (!(GetState(info.This()) & kStateFrozen)) {
+      view->SetElement(index, value->NumberValue());
+    }
+
+    info.GetReturnValue().Set(value);
+    return;
+  }
+
+  if (Bypasses(info.This(), index)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptSet, index);
+  Invalidate(info.This(), index);
+
   Local<Integer> idx = Nan::New<Integer>(index);
   Local<Value> argv2[2] = {idx, value};
   Local<Value> data = info.This()->InternalFieldCount() > 0 ?
@@ -1306,8 +4413,8 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
 
   // if the Proxy isn't trapping, return the
   // value set on the index descriptor
-  if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
-    if (handler->GetHiddenValue(Nan::New<String>("extensible").ToLocalChecked())->BooleanValue() ||
+  if (!(GetState(info.This()) & kStateTrapping)) {
+    if ((GetState(info.This()) & kStateExtensible) ||
       handler->Has(index)
     ) {
       Local<Value> pd = handler->Get(index);
@@ -1320,7 +4427,7 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
       Local<Object> pd_obj = pd->ToObject();
 
       if (!pd_obj->GetHiddenValue(
-            Nan::New<String>("writable").ToLocalChecked())->BooleanValue()
+            Key(kKeyWritable))->BooleanValue()
       ) {
         Nan::ThrowError(
               String::Concat(
@@ -1329,7 +4436,7 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
         return;
       }
 
-      Local<Value> set = pd_obj->Get(Nan::New<String>("set").ToLocalChecked());
+      Local<Value> set = pd_obj->Get(Key(kKeySet));
       if (set->IsFunction()) {
         Local<Function> fn = Local<Function>::Cast(set);
         fn->Call(info.This(), 2, argv2);
@@ -1338,7 +4445,7 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
         return;
       }
 
-      if (pd_obj->Set(Nan::New<String>("value").ToLocalChecked(), value)) {
+      if (pd_obj->Set(Key(kKeyValue), value)) {
         info.GetReturnValue().Set(value);
         return;
       }
@@ -1349,30 +4456,75 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
     return;
   }
 
-  // does the ProxyHandler have a set method?
-  Local<Value> set = handler->Get(Nan::New<String>("set").ToLocalChecked());
-  if (set->IsFunction()) {
-    Local<Function> set_fn = Local<Function>::Cast(set);
-    Local<Value> argv3[3] = {info.This(), idx, value};
-    set_fn->Call(handler, 3, argv3);
+  HandlerRecord *record = HandlerRecord::From(info.This());
 
-    info.GetReturnValue().Set(value);
+  if (record == NULL) {
+    info.GetReturnValue().SetUndefined();
     return;
   }
 
-  Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-  if (getOwnPropertyDescriptor->IsFunction()) {
-    Local<Function> gopd_fn = Local<Function>::Cast(getOwnPropertyDescriptor);
-    Local<Value> argv[1] = {idx};
-    info.GetReturnValue().Set(CallPropertyDescriptorSet(gopd_fn->Call(handler, 1, argv), info.This(), idx, value));
-    return;
+  switch (record->set) {
+    // does the ProxyHandler have a set method?
+    case kSetPathSet: {
+      Local<Value> argv3[3] = {info.This(), idx, value};
+      Local<Value> result = record->Trap(kTrapSet)->Call(handler, 3, argv3);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(value);
+        return;
+      }
+      break;
+    }
+
+    case kSetPathValue: {
+      Local<Value> result = record->Trap(kTrapSetValue)->Call(handler, 2, argv2);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(value);
+        return;
+      }
+      break;
+    }
+
+    case kSetPathOwnPropertyDescriptor: {
+      Local<Function> gopd_fn = record->Trap(kTrapGetOwnPropertyDescriptor);
+      Local<Value> argv[1] = {idx};
+      Local<Value> result = CallPropertyDescriptorSet(gopd_fn->Call(handler, 1, argv), info.This(), idx, value);
+
+      if (!result.IsEmpty()) {
+        info.GetReturnValue().Set(result);
+      }
+      return;
+    }
+
+    case kSetPathPropertyDescriptor: {
+      Local<Function> gpd_fn = record->Trap(kTrapGetPropertyDescriptor);
+      Local<Value> argv[1] = {idx};
+      Local<Value> result = CallPropertyDescriptorSet(gpd_fn->Call(handler, 1, argv), info.This(), idx, value);
+
+      if (!result.IsEmpty()) {
+        info.GetReturnValue().Set(result);
+      }
+      return;
+    }
+
+    default:
+      break;
   }
 
-  Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-  if (getPropertyDescriptor->IsFunction()) {
-    Local<Function> gpd_fn = Local<Function>::Cast(getPropertyDescriptor);
-    Local<Value> argv[1] = {idx};
-    info.GetReturnValue().Set(CallPropertyDescriptorSet(gpd_fn->Call(handler, 1, argv), info.This(), idx, value));
+  Local<Object> target = ForwardTarget(info.This());
+
+  if (!target.IsEmpty()) {
+    target->Set(index, value);
+    info.GetReturnValue().Set(value);
     return;
   }
 
@@ -1387,6 +4539,20 @@ NAN_INDEX_SETTER(NodeProxy::SetIndexedProperty) {
  */
 NAN_INDEX_QUERY(NodeProxy::QueryIndexedPropertyInteger) {
 
+  ProxyExtension *view = Viewing(info.This());
+
+  if (view != NULL && index < view->ElementCount()) {
+    info.GetReturnValue().Set(Nan::New<Integer>(DontDelete));
+    return;
+  }
+
+  if (info.This()->InternalFieldCount() >= kProxyFieldCount &&
+      Bypasses(info.This(), index)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptQuery, index);
+
   Local<Integer> idx = Nan::New<Integer>(index);
   Local<Integer> DoesntHavePropertyResponse;
   Local<Integer> HasPropertyResponse = Nan::New<Integer>(None);
@@ -1405,7 +4571,7 @@ NAN_INDEX_QUERY(NodeProxy::QueryIndexedPropertyInteger) {
 
     // if the Proxy isn't trapping,
     // return the value set on the property descriptor
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(info.This()) & kStateTrapping)) {
       if (handler->Has(index)) {
         Local<Value> pd = handler->Get(index);
 
@@ -1422,48 +4588,87 @@ NAN_INDEX_QUERY(NodeProxy::QueryIndexedPropertyInteger) {
 
     Local<Value> argv[1] = {idx};
 
-    Local<Value> hasOwn = handler->Get(Nan::New<String>("hasOwn").ToLocalChecked());
-    if (hasOwn->IsFunction()) {
-      Local<Function> hasOwn_fn = Local<Function>::Cast(hasOwn);
-      info.GetReturnValue().Set(hasOwn_fn->Call(handler, 1, argv)->BooleanValue() ?
-                     HasPropertyResponse :
-                     DoesntHavePropertyResponse);
+    HandlerRecord *record = HandlerRecord::From(info.This());
+
+    if (record == NULL) {
+      info.GetReturnValue().Set(DoesntHavePropertyResponse);
       return;
     }
 
-    Local<Value> has = handler->Get(Nan::New<String>("has").ToLocalChecked());
-    if (has->IsFunction()) {
-      Local<Function> has_fn = Local<Function>::Cast(has);
-      info.GetReturnValue().Set(has_fn->Call(handler, 1, argv)->BooleanValue() ?
-                     HasPropertyResponse :
-                     DoesntHavePropertyResponse);
+    ProxyExtension *caching = Caching(info.This(), kStateCachingQueries);
+    int32_t cached;
+
+    if (caching != NULL && caching->attributes->Find(PropertyName(index), &cached)) {
+      if (cached != AttributeCache::kAbsent) {
+        info.GetReturnValue().Set(Nan::New<Integer>(cached));
+      }
       return;
     }
 
-    Local<Value> getOwnPropertyDescriptor = handler->Get(Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked());
-    if (getOwnPropertyDescriptor->IsFunction()) {
-      Local<Function> gopd_fn = Local<Function>::Cast(getOwnPropertyDescriptor);
+    if (record->query == kQueryPathHasOwn || record->query == kQueryPathHas) {
+      Local<Function> fn = record->Trap(record->query == kQueryPathHasOwn ?
+                                        kTrapHasOwn : kTrapHas);
+      Local<Value> result = fn->Call(handler, 1, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(RememberQuery(caching, index,
+                       result->BooleanValue() ?
+                       HasPropertyResponse :
+                       DoesntHavePropertyResponse));
+        return;
+      }
+    } else if (record->HasTrap(kTrapGetOwnPropertyDescriptor)) {
+      Local<Function> gopd_fn = record->Trap(kTrapGetOwnPropertyDescriptor);
       Local<Value> gopd_pd = gopd_fn->Call(handler, 1, argv);
 
+      if (gopd_pd.IsEmpty()) {
+        return;
+      }
+
       if (gopd_pd->IsObject()) {
-        info.GetReturnValue().Set(GetPropertyAttributeFromPropertyDescriptor(gopd_pd->ToObject()));
+        info.GetReturnValue().Set(RememberQuery(caching, index,
+            GetPropertyAttributeFromPropertyDescriptor(gopd_pd->ToObject())));
         return;
       }
     }
 
-    Local<Value> getPropertyDescriptor = handler->Get(Nan::New<String>("getPropertyDescriptor").ToLocalChecked());
-    if (handler->Has(Nan::New<String>("getPropertyDescriptor").ToLocalChecked())) {
-      Local<Function> gpd_fn = Local<Function>::Cast(getPropertyDescriptor);
+    if (record->query == kQueryPathDescriptor &&
+        record->HasTrap(kTrapGetPropertyDescriptor)) {
+      Local<Function> gpd_fn = record->Trap(kTrapGetPropertyDescriptor);
       Local<Value> gpd_pd = gpd_fn->Call(handler, 1, argv);
 
+      if (gpd_pd.IsEmpty()) {
+        return;
+      }
+
       if (gpd_pd->IsObject()) {
-        info.GetReturnValue().Set(GetPropertyAttributeFromPropertyDescriptor(gpd_pd->ToObject()));
+        info.GetReturnValue().Set(RememberQuery(caching, index,
+            GetPropertyAttributeFromPropertyDescriptor(gpd_pd->ToObject())));
         return;
       } else if (gpd_pd->IsUndefined()) {
-        info.GetReturnValue().Set(DoesntHavePropertyResponse);
+        info.GetReturnValue().Set(RememberQuery(caching, index,
+            DoesntHavePropertyResponse));
         return;
       }
     }
+
+    Local<Object> target = ForwardTarget(info.This());
+
+    if (!target.IsEmpty()) {
+      info.GetReturnValue().Set(target->Has(index) ?
+                     HasPropertyResponse :
+                     DoesntHavePropertyResponse);
+      return;
+    }
+
+    // no trap reported the element
+    info.GetReturnValue().Set(RememberQuery(caching, index,
+        DoesntHavePropertyResponse));
+    return;
   }
 
   info.GetReturnValue().Set(DoesntHavePropertyResponse);
@@ -1477,6 +4682,22 @@ NAN_INDEX_QUERY(NodeProxy::QueryIndexedPropertyInteger) {
  */
 NAN_INDEX_DELETER(NodeProxy::DeleteIndexedProperty) {
 
+  ProxyExtension *view = Viewing(info.This());
+
+  // the elements of a typed array cannot be deleted
+  if (view != NULL && index < view->ElementCount()) {
+    info.GetReturnValue().Set(Nan::False());
+    return;
+  }
+
+  if (info.This()->InternalFieldCount() >= kProxyFieldCount &&
+      Bypasses(info.This(), index)) {
+    return;
+  }
+
+  TrapScope trap_scope(info.This(), kInterceptDelete, index);
+  Invalidate(info.This(), index);
+
   if (info.This()->InternalFieldCount() > 0 || !info.Data().IsEmpty()) {
     Local<Value> data = info.This()->InternalFieldCount() > 0 ?
                  info.This()->GetInternalField(0) :
@@ -1491,15 +4712,15 @@ NAN_INDEX_DELETER(NodeProxy::DeleteIndexedProperty) {
     Local<Object> handler = data->ToObject();
     // if the Proxy isn't trapping,
     // return the value set on the property descriptor
-    if (!handler->GetHiddenValue(Nan::New<String>("trapping").ToLocalChecked())->BooleanValue()) {
-      if (!handler->GetHiddenValue(Nan::New<String>("frozen").ToLocalChecked())->BooleanValue()) {
+    if (!(GetState(info.This()) & kStateTrapping)) {
+      if (!(GetState(info.This()) & kStateFrozen)) {
         Local<Value> pd = handler->Get(idx);
 
         if (pd->IsObject()) {
           Local<Object> pd_obj = pd->ToObject();
 
-          if (pd_obj->Get(Nan::New<String>("configurable").ToLocalChecked())->IsBoolean() &&
-              pd_obj->Get(Nan::New<String>("configurable").ToLocalChecked())->BooleanValue()
+          if (pd_obj->Get(Key(kKeyConfigurable))->IsBoolean() &&
+              pd_obj->Get(Key(kKeyConfigurable))->BooleanValue()
           ) {
             info.GetReturnValue().Set(Nan::New<Boolean>(handler->Delete(index)));
             return;
@@ -1510,11 +4731,27 @@ NAN_INDEX_DELETER(NodeProxy::DeleteIndexedProperty) {
       return;
     }
 
-    Local<Value> delete_ = handler->Get(Nan::New<String>("delete").ToLocalChecked());
-    if (delete_->IsFunction()) {
-      Local<Function> fn = Local<Function>::Cast(delete_);
+    HandlerRecord *record = HandlerRecord::From(info.This());
+
+    if (record != NULL && record->HasTrap(kTrapDelete)) {
+      Local<Function> fn = record->Trap(kTrapDelete);
       Local<Value> argv[1] = {idx};
-      info.GetReturnValue().Set(fn->Call(handler, 1, argv)->ToBoolean());
+      Local<Value> result = fn->Call(handler, 1, argv);
+
+      if (result.IsEmpty()) {
+        return;
+      }
+
+      if (!Forwards(info.This(), result)) {
+        info.GetReturnValue().Set(result->ToBoolean());
+        return;
+      }
+    }
+
+    Local<Object> target = ForwardTarget(info.This());
+
+    if (!target.IsEmpty()) {
+      info.GetReturnValue().Set(Nan::New<Boolean>(target->Delete(index)));
       return;
     }
   }
@@ -1522,6 +4759,48 @@ NAN_INDEX_DELETER(NodeProxy::DeleteIndexedProperty) {
   info.GetReturnValue().Set(Nan::New<Boolean>(false));
 }
 
+/**
+ *  Invoked for enumerating the indexed properties of an object,
+ *  every element of an array view or every index in the range
+ *  returned by the indexRange trap, into a pre-sized Array
+ *  Other handlers list their indices through the named enumerator
+ *
+ */
+NAN_INDEX_ENUMERATOR(NodeProxy::EnumerateIndexedProperties) {
+
+  TrapScope trap_scope(info.This(), kInterceptEnumerate);
+
+  ProxyExtension *view = Viewing(info.This());
+  uint32_t start = 0;
+  uint32_t end = 0;
+
+  if (view != NULL) {
+    end = view->ElementCount();
+  } else {
+    Nan::TryCatch tc;
+    bool ranged = info.This()->InternalFieldCount() >= kProxyFieldCount &&
+        IndexRange(info.This(), HandlerRecord::From(info.This()), &start, &end);
+
+    if (tc.HasCaught()) {
+      tc.ReThrow();
+      return;
+    }
+
+    if (!ranged) {
+      info.GetReturnValue().Set(Nan::New<Array>());
+      return;
+    }
+  }
+
+  Local<Array> indices = Nan::New<Array>(static_cast<int>(end - start));
+
+  for (uint32_t i = start; i < end; ++i) {
+    indices->Set(i - start, Nan::New<Integer>(i));
+  }
+
+  info.GetReturnValue().Set(indices);
+}
+
 /**
  *  Initialize the NodeProxy Strings and functions
  *
@@ -1531,6 +4810,8 @@ NAN_INDEX_DELETER(NodeProxy::DeleteIndexedProperty) {
 void NodeProxy::Init(Handle<Object> target) {
   Nan::HandleScope scope;
 
+  InitKeys();
+
 // function creation
 
 // main functions
@@ -1544,52 +4825,84 @@ void NodeProxy::Init(Handle<Object> target) {
   create->SetName(_createFunction);
   target->Set(_createFunction, createFunction);
 
+  Local<Function> createForwarding = Nan::New<FunctionTemplate>(CreateForwarding)->GetFunction();
+  Local<String> _createForwarding = Nan::New<String>("createForwarding").ToLocalChecked();
+  createForwarding->SetName(_createForwarding);
+  target->Set(_createForwarding, createForwarding);
+
+  Local<Function> createCached = Nan::New<FunctionTemplate>(CreateCached)->GetFunction();
+  Local<String> _createCached = Nan::New<String>("createCached").ToLocalChecked();
+  createCached->SetName(_createCached);
+  target->Set(_createCached, createCached);
+
+  Local<Function> createArrayView = Nan::New<FunctionTemplate>(CreateArrayView)->GetFunction();
+  Local<String> _createArrayView = Nan::New<String>("createArrayView").ToLocalChecked();
+  createArrayView->SetName(_createArrayView);
+  target->Set(_createArrayView, createArrayView);
+
+  Local<Function> createStruct = Nan::New<FunctionTemplate>(CreateStruct)->GetFunction();
+  Local<String> _createStruct = Nan::New<String>("createStruct").ToLocalChecked();
+  createStruct->SetName(_createStruct);
+  target->Set(_createStruct, createStruct);
+
+  // the sentinel traps of a forwarding proxy return, @see NodeProxy::Forwards
+  Local<Object> forward = Nan::New<Object>();
+  IsolateData()->forward.Reset(forward);
+  target->Set(Key(kKeyForward), forward);
+
 // freeze function assignment
-  Local<Function> freeze = Nan::New<FunctionTemplate>(Freeze)->GetFunction();
-  Local<String> _freeze = Nan::New<String>("freeze").ToLocalChecked();
+  Local<Function> freeze = Nan::New<FunctionTemplate>(Freeze,
+      Nan::New<Integer>(kLockFreeze))->GetFunction();
+  Local<String> _freeze = Key(kKeyFreeze);
   freeze->SetName(_freeze);
   target->Set(_freeze, freeze);
 
-  Local<Function> seal = Nan::New<FunctionTemplate>(Freeze)->GetFunction();
-  Local<String> _seal = Nan::New<String>("seal").ToLocalChecked();
+  Local<Function> seal = Nan::New<FunctionTemplate>(Freeze,
+      Nan::New<Integer>(kLockSeal))->GetFunction();
+  Local<String> _seal = Key(kKeySeal);
   seal->SetName(_seal);
   target->Set(_seal, seal);
 
-  Local<Function> prevent = Nan::New<FunctionTemplate>(Freeze)->GetFunction();
-  Local<String> _preventExtensions = Nan::New<String>("preventExtensions").ToLocalChecked();
+  Local<Function> prevent = Nan::New<FunctionTemplate>(Freeze,
+      Nan::New<Integer>(kLockPreventExtensions))->GetFunction();
+  Local<String> _preventExtensions = Key(kKeyPreventExtensions);
   prevent->SetName(_preventExtensions);
   target->Set(_preventExtensions, prevent);
 
 // check function assignment
-  Local<Function> isfrozen = Nan::New<FunctionTemplate>(IsLocked)->GetFunction();
-  Local<String> _isFrozen = Nan::New<String>("isFrozen").ToLocalChecked();
+  Local<Function> isfrozen = Nan::New<FunctionTemplate>(IsLocked,
+      Nan::New<Integer>(kLockIsFrozen))->GetFunction();
+  Local<String> _isFrozen = Key(kKeyIsFrozen);
   isfrozen->SetName(_isFrozen);
   target->Set(_isFrozen, isfrozen);
 
-  Local<Function> issealed = Nan::New<FunctionTemplate>(IsLocked)->GetFunction();
-  Local<String> _isSealed = Nan::New<String>("isSealed").ToLocalChecked();
+  Local<Function> issealed = Nan::New<FunctionTemplate>(IsLocked,
+      Nan::New<Integer>(kLockIsSealed))->GetFunction();
+  Local<String> _isSealed = Key(kKeyIsSealed);
   issealed->SetName(_isSealed);
   target->Set(_isSealed, issealed);
 
-  Local<Function> isextensible = Nan::New<FunctionTemplate>(IsLocked)->GetFunction();
-  Local<String> _isExtensible = Nan::New<String>("isExtensible").ToLocalChecked();
+  Local<Function> isextensible = Nan::New<FunctionTemplate>(IsLocked,
+      Nan::New<Integer>(kLockIsExtensible))->GetFunction();
+  Local<String> _isExtensible = Key(kKeyIsExtensible);
   isextensible->SetName(_isExtensible);
   target->Set(_isExtensible, isextensible);
 
 // part of harmony proxies
-  Local<Function> istrapping = Nan::New<FunctionTemplate>(IsLocked)->GetFunction();
-  Local<String> _isTrapping = Nan::New<String>("isTrapping").ToLocalChecked();
+  Local<Function> istrapping = Nan::New<FunctionTemplate>(IsLocked,
+      Nan::New<Integer>(kLockIsTrapping))->GetFunction();
+  Local<String> _isTrapping = Key(kKeyIsTrapping);
   istrapping->SetName(_isTrapping);
   target->Set(_isTrapping, istrapping);
 
 // ECMAScript 5
   Local<Function> getOwnPropertyDescriptor = Nan::New<FunctionTemplate>(GetOwnPropertyDescriptor)->GetFunction();
-  Local<String> _getOwnPropertyDescriptor = Nan::New<String>("getOwnPropertyDescriptor").ToLocalChecked();
+  Local<String> _getOwnPropertyDescriptor = Key(kKeyGetOwnPropertyDescriptor);
   getOwnPropertyDescriptor->SetName(_getOwnPropertyDescriptor);
   target->Set(_getOwnPropertyDescriptor, getOwnPropertyDescriptor);
 
   Local<Function> defineProperty = Nan::New<FunctionTemplate>(DefineProperty)->GetFunction();
-  Local<String> _defineProperty = Nan::New<String>("defineProperty").ToLocalChecked();
+  Local<String> _defineProperty = Key(kKeyDefineProperty);
   defineProperty->SetName(_defineProperty);
   target->Set(_defineProperty, defineProperty);
 
@@ -1619,50 +4932,92 @@ void NodeProxy::Init(Handle<Object> target) {
   hidden->SetName(_isProxy);
   target->Set(_isProxy, isProxy_);
 
-  Local<ObjectTemplate> temp = Nan::New<ObjectTemplate>();
-
-  temp->SetInternalFieldCount(1);
-
-  // named property handlers
-  Nan::SetNamedPropertyHandler(
-    temp,
-    GetNamedProperty,
-    SetNamedProperty,
-    QueryNamedPropertyInteger,
-    DeleteNamedProperty,
-    EnumerateNamedProperties);
-
-  // indexed property handlers
-  // TODO: properly implement arrays
-  Nan::SetIndexedPropertyHandler(
-    temp,
-    GetIndexedProperty,
-    SetIndexedProperty,
-    QueryIndexedPropertyInteger,
-    DeleteIndexedProperty);
-  
-  ObjectCreator.Reset(temp);
-
-  Local<ObjectTemplate> instance = Nan::New<ObjectTemplate>();
-  Nan::SetCallAsFunctionHandler(instance, NodeProxy::New);
-  instance->SetInternalFieldCount(1);
-
-  Nan::SetNamedPropertyHandler(
-    instance,
-    GetNamedProperty,
-    SetNamedProperty,
-    QueryNamedPropertyInteger,
-    DeleteNamedProperty,
-    EnumerateNamedProperties);
-
-  Nan::SetIndexedPropertyHandler(
-    instance,
-    GetIndexedProperty,
-    SetIndexedProperty,
-    QueryIndexedPropertyInteger,
-    DeleteIndexedProperty);
-
-  FunctionCreator.Reset(instance);
+  Local<Function> refreshHandler = Nan::New<FunctionTemplate>(RefreshHandler)->GetFunction();
+  Local<String> _refreshHandler = Nan::New<String>("refreshHandler").ToLocalChecked();
+  refreshHandler->SetName(_refreshHandler);
+  target->Set(_refreshHandler, refreshHandler);
+
+// instrumentation
+  Local<Function> enableStats = Nan::New<FunctionTemplate>(EnableStats)->GetFunction();
+  Local<String> _enableStats = Nan::New<String>("enableStats").ToLocalChecked();
+  enableStats->SetName(_enableStats);
+  target->Set(_enableStats, enableStats);
+
+  Local<Function> stats = Nan::New<FunctionTemplate>(Stats)->GetFunction();
+  Local<String> _stats = Nan::New<String>("stats").ToLocalChecked();
+  stats->SetName(_stats);
+  target->Set(_stats, stats);
+
+  Local<Function> resetStats = Nan::New<FunctionTemplate>(ResetStats)->GetFunction();
+  Local<String> _resetStats = Nan::New<String>("resetStats").ToLocalChecked();
+  resetStats->SetName(_resetStats);
+  target->Set(_resetStats, resetStats);
+
+  Local<Function> enableTrace = Nan::New<FunctionTemplate>(EnableTrace)->GetFunction();
+  Local<String> _enableTrace = Nan::New<String>("enableTrace").ToLocalChecked();
+  enableTrace->SetName(_enableTrace);
+  target->Set(_enableTrace, enableTrace);
+
+  Local<Function> dumpTrace = Nan::New<FunctionTemplate>(DumpTrace)->GetFunction();
+  Local<String> _dumpTrace = Nan::New<String>("dumpTrace").ToLocalChecked();
+  dumpTrace->SetName(_dumpTrace);
+  target->Set(_dumpTrace, dumpTrace);
+
+  Local<Function> trackHotKeys = Nan::New<FunctionTemplate>(TrackHotKeys)->GetFunction();
+  Local<String> _trackHotKeys = Nan::New<String>("trackHotKeys").ToLocalChecked();
+  trackHotKeys->SetName(_trackHotKeys);
+  target->Set(_trackHotKeys, trackHotKeys);
+
+  Local<Function> hotKeys = Nan::New<FunctionTemplate>(HotKeys)->GetFunction();
+  Local<String> _hotKeys = Nan::New<String>("hotKeys").ToLocalChecked();
+  hotKeys->SetName(_hotKeys);
+  target->Set(_hotKeys, hotKeys);
+
+  Local<Function> cacheStats = Nan::New<FunctionTemplate>(CacheStats)->GetFunction();
+  Local<String> _cacheStats = Nan::New<String>("cacheStats").ToLocalChecked();
+  cacheStats->SetName(_cacheStats);
+  target->Set(_cacheStats, cacheStats);
+
+  Local<Function> clearCache = Nan::New<FunctionTemplate>(ClearCache)->GetFunction();
+  Local<String> _clearCache = Nan::New<String>("clearCache").ToLocalChecked();
+  clearCache->SetName(_clearCache);
+  target->Set(_clearCache, clearCache);
+
+// batched access
+  Local<Function> getMany = Nan::New<FunctionTemplate>(GetMany)->GetFunction();
+  Local<String> _getMany = Key(kKeyGetMany);
+  getMany->SetName(_getMany);
+  target->Set(_getMany, getMany);
+
+  Local<Function> setMany = Nan::New<FunctionTemplate>(SetMany)->GetFunction();
+  Local<String> _setMany = Key(kKeySetMany);
+  setMany->SetName(_setMany);
+  target->Set(_setMany, setMany);
+
+  // holds the resolved traps of a handler, @see HandlerRecord
+  Local<ObjectTemplate> record = Nan::New<ObjectTemplate>();
+  record->SetInternalFieldCount(kTrapCount + 1);
+  HandlerRecord::RecordCreator.Reset(record);
+
+  // holds the native state of a single proxy, @see ProxyExtension
+  Local<ObjectTemplate> extension = Nan::New<ObjectTemplate>();
+  extension->SetInternalFieldCount(ProxyExtension::kStaticsField + 1);
+  ProxyExtension::ExtensionCreator.Reset(extension);
+
+  // holds the compiled schema of createStruct, @see StructRecord
+  Local<ObjectTemplate> layout = Nan::New<ObjectTemplate>();
+  layout->SetInternalFieldCount(StructRecord::kHandlerField + 1);
+  StructRecord::StructCreator.Reset(layout);
+
+  // holds the compiled names of a statics object, @see NameRecord
+  Local<ObjectTemplate> names = Nan::New<ObjectTemplate>();
+  names->SetInternalFieldCount(1);
+  NameRecord::NameCreator.Reset(names);
+
+  // templates with every interceptor installed, the rest of
+  // the shapes are built on demand, @see NodeProxy::Template
+  ObjectCreator.Reset(Template(kShapeAll));
+  FunctionCreator.Reset(Template(kShapeAll | kShapeFunction));
 }
 
 /**
@@ -34,10 +34,20 @@
 #define NODE_PROXY_H
 
 
+#include <stdio.h>
+#include <string>
+#include <vector>
+#include <uv.h>
 #include <v8.h>
 #include <node.h>
 #include <node_version.h>
 #include "nan.h"
+#include "./property-name.h"
+#include "./probes.h"
+#include "./hot-keys.h"
+#include "./read-cache.h"
+#include "./array-view.h"
+#include "./struct-layout.h"
 
 using namespace v8;
 using namespace node;
@@ -49,15 +59,589 @@ using namespace node;
     || ((major) == NODE_MAJOR_VERSION && (minor) == NODE_MINOR_VERSION && \
     (patch) <= NODE_PATCH_VERSION))
 
+// the keys used by the interceptors and API methods,
+// indexes into ProxyIsolateData::keys
+enum ProxyKey {
+  kKeyGet = 0,
+  kKeySet,
+  kKeyHas,
+  kKeyHasOwn,
+  kKeyDelete,
+  kKeyEnumerate,
+  kKeyKeys,
+  kKeyGetPropertyNames,
+  kKeyGetPropertyDescriptor,
+  kKeyGetOwnPropertyDescriptor,
+  kKeyDefineProperty,
+  kKeyFix,
+  kKeyGetValue,
+  kKeySetValue,
+  kKeyIndexRange,
+  kKeyGetMany,
+  kKeySetMany,
+  kKeyValue,
+  kKeyWritable,
+  kKeyConfigurable,
+  kKeyEnumerable,
+  kKeyLength,
+  kKeyNext,
+  kKeyDone,
+  kKeySize,
+  kKeyTrapping,
+  kKeyExtensible,
+  kKeySealed,
+  kKeyFrozen,
+  kKeyFreeze,
+  kKeySeal,
+  kKeyPreventExtensions,
+  kKeyIsExtensible,
+  kKeyIsSealed,
+  kKeyIsTrapping,
+  kKeyIsFrozen,
+  kKeyHiddenPrefix,
+  kKeyRecord,
+  kKeyLayout,
+  kKeyNamed,
+  kKeyIndexed,
+  kKeyNonMasking,
+  kKeyIgnore,
+  kKeyMaterialize,
+  kKeyForward,
+  kKeyStatics,
+  kKeyCacheQueries,
+  kKeyObject,
+  kKeyCreate,
+  kKeyMaxEntries,
+  kKeyTtlMs,
+  kKeyNames,
+  kKeyCount
+};
+
+// the interceptors installed on the template a proxy is created
+// from, the getters are installed whenever named or indexed is
+enum ProxyShape {
+  kShapeSet = 1 << 0,
+  kShapeQuery = 1 << 1,
+  kShapeDelete = 1 << 2,
+  kShapeEnumerate = 1 << 3,
+  kShapeNamed = 1 << 4,
+  kShapeIndexed = 1 << 5,
+  kShapeFunction = 1 << 6,
+  kShapeNonMasking = 1 << 7,
+  kShapeArrayView = 1 << 8,
+  kShapeAll = kShapeSet | kShapeQuery | kShapeDelete |
+              kShapeEnumerate | kShapeNamed | kShapeIndexed,
+  kShapeCount = 1 << 9
+};
+
+// the optional last argument of create and createFunction
+struct ProxyOptions {
+  bool named;
+  bool indexed;
+  bool nonMasking;
+  bool materialize;
+  Local<Value> ignore;
+  Local<Value> statics;
+  // only set by createForwarding
+  Local<Object> target;
+  // only set by createCached, the ttl is in nanoseconds
+  uint32_t maxEntries;
+  uint64_t ttl;
+  // the number of names whose query results are kept
+  uint32_t queryEntries;
+  // only set by createArrayView
+  Local<Value> view;
+  // only set by createStruct, bytes is a view of the whole buffer
+  Local<Object> layout;
+  Local<Value> bytes;
+  uint32_t byteOffset;
+  // whether names outside the schema reach the handler
+  bool trapsUnknown;
+};
+
+// internalized key handles, built once per isolate in
+// NodeProxy::Init, and the templates of every shape in use
+struct ProxyIsolateData {
+  Isolate *isolate;
+  ProxyIsolateData *next;
+#if PROXY_NODE_VERSION_AT_LEAST(0, 12, 0)
+  Eternal<String> keys[kKeyCount];
+#else
+  Nan::Persistent<String> keys[kKeyCount];
+#endif
+  Nan::Persistent<ObjectTemplate> templates[kShapeCount];
+  // returned by a trap to forward the access to the target
+  Nan::Persistent<Object> forward;
+};
+
+// the traps a ProxyHandler may define, in the same
+// order as the leading entries of ProxyKey
+enum ProxyTrap {
+  kTrapGet = 0,
+  kTrapSet,
+  kTrapHas,
+  kTrapHasOwn,
+  kTrapDelete,
+  kTrapEnumerate,
+  kTrapKeys,
+  kTrapGetPropertyNames,
+  kTrapGetPropertyDescriptor,
+  kTrapGetOwnPropertyDescriptor,
+  kTrapDefineProperty,
+  kTrapFix,
+  kTrapGetValue,
+  kTrapSetValue,
+  kTrapIndexRange,
+  kTrapGetMany,
+  kTrapSetMany,
+  kTrapCount
+};
+
+// which trap answers each kind of access first
+enum GetPath {
+  kGetPathNone = 0,
+  kGetPathGet,
+  kGetPathPropertyDescriptor,
+  kGetPathOwnPropertyDescriptor,
+  kGetPathValue
+};
+
+enum SetPath {
+  kSetPathNone = 0,
+  kSetPathSet,
+  kSetPathOwnPropertyDescriptor,
+  kSetPathPropertyDescriptor,
+  kSetPathValue
+};
+
+enum QueryPath {
+  kQueryPathNone = 0,
+  kQueryPathHasOwn,
+  kQueryPathHas,
+  kQueryPathDescriptor
+};
+
+enum EnumeratePath {
+  kEnumeratePathNone = 0,
+  kEnumeratePathEnumerate,
+  kEnumeratePathKeys,
+  kEnumeratePathPropertyNames
+};
+
+// internal fields of an object created by Proxy
+enum ProxyField {
+  kHandlerField = 0,
+  kRecordField,
+  kStateField,
+  kExtensionField,
+  kProxyFieldCount,
+
+  // functions created by Proxy also carry their traps
+  kCallTrapField = kProxyFieldCount,
+  kConstructorTrapField,
+  kFunctionFieldCount
+};
+
+// arguments forwarded by NodeProxy::New without a heap allocation
+static const int kStackArgumentCount = 16;
+
+// the largest size hint of an enumeration iterator that
+// is allocated up front, @see NodeProxy::CollectNames
+static const uint32_t kMaxNameHint = 1 << 16;
+
+// the most indices an indexRange may span, the length of
+// the largest array its indices are enumerated into
+static const uint32_t kMaxIndexRange = 0x7fffffff;
+
+// the longest ttlMs of createCached, a year, so that the
+// ttl stays far within the nanoseconds a uint64_t holds
+static const double kMaxCacheTtl = 365 * 24 * 3600 * 1e3;
+
+// lock state of an object created by Proxy, packed into the
+// aligned pointer of kStateField, so bit 0 must stay clear
+enum ProxyState {
+  kStateTrapping = 1 << 1,
+  kStateExtensible = 1 << 2,
+  kStateSealed = 1 << 3,
+  kStateFrozen = 1 << 4,
+
+  // options the interceptors check before entering the handler
+  kStateIgnoring = 1 << 5,
+  kStateNonMasking = 1 << 6,
+  kStateMaterialize = 1 << 7,
+  kStateForwarding = 1 << 8,
+  kStateCaching = 1 << 9,
+  kStateCachingQueries = 1 << 10,
+  kStateArrayView = 1 << 11,
+  kStateStruct = 1 << 12
+};
+
+// the bits above the flags hold the thread a proxy is reported
+// as by NodeProxy::DumpTrace, given on its first traced call
+static const int kStateTraceShift = 13;
+static const uint32_t kMaxTraceId = 0xffffffff >> kStateTraceShift;
+
+// the locking and lock checking functions, bound
+// as data to Freeze and IsLocked in NodeProxy::Init
+enum ProxyLock {
+  kLockFreeze = 0,
+  kLockSeal,
+  kLockPreventExtensions,
+  kLockIsFrozen,
+  kLockIsSealed,
+  kLockIsExtensible,
+  kLockIsTrapping,
+  kLockCount
+};
+
+// the interceptors counted by TrapStats
+enum ProxyIntercept {
+  kInterceptGet = 0,
+  kInterceptSet,
+  kInterceptQuery,
+  kInterceptDelete,
+  kInterceptEnumerate,
+  kInterceptCall,
+  kInterceptConstruct,
+  kInterceptCount
+};
+
+// every dispatch path enum has this many values
+static const int kPathCount = 5;
+
+// latencies are bucketed by the highest bit set in nanoseconds
+static const int kLatencyBucketCount = 32;
+
+/**
+ *  Counters of a single HandlerRecord, only allocated
+ *  once stats are enabled, @see NodeProxy::EnableStats
+ */
+struct TrapStats {
+  uint64_t calls[kInterceptCount];
+  uint64_t paths[kInterceptCount][kPathCount];
+  uint64_t latency[kInterceptCount][kLatencyBucketCount];
+};
+
+/**
+ *  The traps of a ProxyHandler, resolved once and shared by every
+ *  proxy created from that handler, so that the interceptors
+ *  dispatch without looking up trap names on the handler.
+ *  The trap functions live in the internal fields of the wrapping
+ *  object, so they are traced by the GC like any other reference.
+ */
+class HandlerRecord : public Nan::ObjectWrap {
+  public:
+  HandlerRecord() : stats(NULL), hotKeys(NULL) {}
+  ~HandlerRecord() { delete stats; delete hotKeys; }
+
+  static Nan::Persistent<ObjectTemplate> RecordCreator;
+  static Local<Object> New(Local<Object> handler);
+  static Local<Object> For(Local<Object> handler);
+  static NAN_INLINE HandlerRecord *From(Local<Object> proxy);
+
+  void Resolve(Local<Object> handler);
+
+  NAN_INLINE bool HasTrap(ProxyTrap trap) const {
+    return (traps & (1 << trap)) != 0;
+  }
+
+  NAN_INLINE Local<Function> Trap(ProxyTrap trap) const {
+    return Local<Function>::Cast(handle()->GetInternalField(trap + 1));
+  }
+
+  uint32_t traps;
+  GetPath get;
+  SetPath set;
+  QueryPath query;
+  EnumeratePath enumerate;
+
+  // NULL until stats are enabled
+  TrapStats *stats;
+
+  // NULL unless hot keys are tracked, @see NodeProxy::TrackHotKeys
+  HotKeySketch *hotKeys;
+};
+
+// entries kept by the trace ring buffer, @see NodeProxy::DumpTrace
+static const uint32_t kTraceCapacity = 4096;
+
+// bytes of a property name kept by a trace entry
+static const int kTraceNameLength = 32;
+
+/**
+ *  A single interceptor call recorded while tracing,
+ *  fixed size so recording never allocates
+ */
+struct TraceEntry {
+  uint64_t start;
+  uint64_t duration;
+  uint32_t proxy;
+  ProxyIntercept intercept;
+  uint32_t index;
+  int nameLength;
+  char name[kTraceNameLength];
+};
+
+/**
+ *  Counts an interceptor call and its latency against the
+ *  HandlerRecord of the proxy, records it in the trace
+ *  ring buffer and fires the USDT probes, for as long as it is in scope
+ *  With all of them disabled this costs one branch on a global flag,
+ *  plus a test of the probe semaphores when USDT is available
+ *
+ */
+class TrapScope {
+  public:
+  enum {
+    kStats = 1 << 0,
+    kTrace = 1 << 1
+  };
+
+  // not a valid array index, marks calls without a property
+  static const uint32_t kNoIndex = 0xffffffff;
+
+  static uint32_t Enabled;
+
+  // the ring buffer, the oldest entries are overwritten,
+  // TraceCount keeps counting so that dropped calls are known
+  static TraceEntry Trace[kTraceCapacity];
+  static uint64_t TraceCount;
+  // the last id given to a traced proxy, @see kStateTraceShift
+  static uint32_t TraceIds;
+
+  NAN_INLINE TrapScope(Local<Object> proxy, ProxyIntercept intercept)
+      : active_(false) {
+    if (Enabled || PROXY_PROBES_ENABLED()) {
+      Begin(proxy, intercept, Local<String>(), kNoIndex);
+    }
+  }
+
+  NAN_INLINE TrapScope(Local<Object> proxy, ProxyIntercept intercept,
+                       Local<String> property)
+      : active_(false) {
+    if (Enabled || PROXY_PROBES_ENABLED()) {
+      Begin(proxy, intercept, property, kNoIndex);
+    }
+  }
+
+  NAN_INLINE TrapScope(Local<Object> proxy, ProxyIntercept intercept,
+                       uint32_t index)
+      : active_(false) {
+    if (Enabled || PROXY_PROBES_ENABLED()) {
+      Begin(proxy, intercept, Local<String>(), index);
+    }
+  }
+
+  NAN_INLINE ~TrapScope() {
+    if (active_) {
+      End();
+    }
+  }
+
+  private:
+  void Begin(Local<Object> proxy, ProxyIntercept intercept,
+             Local<String> property, uint32_t index);
+  void End();
+
+  bool active_;
+  bool tracing_;
+  TrapStats *stats_;
+  uint32_t traceId_;
+  uint32_t index_;
+  Local<String> property_;
+  HandlerRecord *record_;
+  ProxyIntercept intercept_;
+  uint64_t start_;
+};
+
+/**
+ *  The compiled schema of createStruct, cached on the
+ *  schema object like HandlerRecord is on a handler
+ *
+ */
+class StructRecord : public Nan::ObjectWrap {
+  public:
+  static Nan::Persistent<ObjectTemplate> StructCreator;
+  static Local<Object> For(Local<Object> schema);
+
+  // the handler of structs created without one
+  static const int kHandlerField = 1;
+
+  StructLayout layout;
+};
+
+/**
+ *  The names of a statics object, compiled once and cached on
+ *  the object like StructRecord is on a schema, so that every
+ *  proxy created with the same statics shares them
+ *
+ */
+class NameRecord : public Nan::ObjectWrap {
+  public:
+  static Nan::Persistent<ObjectTemplate> NameCreator;
+  static Local<Object> For(Local<Object> statics);
+
+  NameSet names;
+};
+
+/**
+ *  Native state of a single proxy, only attached to proxies
+ *  created with options that need it.
+ *  Like HandlerRecord it is owned by a wrapping object held in an
+ *  internal field of the proxy, so clones of a proxy share it and
+ *  it is freed along with the last of them.
+ */
+class ProxyExtension : public Nan::ObjectWrap {
+  public:
+  ProxyExtension() : cache(NULL), attributes(NULL), elements(ArrayView::kNone),
+                     layout(NULL), byteOffset(0), trapsUnknown(false),
+                     statics(NULL) {}
+  ~ProxyExtension() {
+    delete cache;
+    delete attributes;
+  }
+
+  static Nan::Persistent<ObjectTemplate> ExtensionCreator;
+  static Local<Object> New();
+  static NAN_INLINE ProxyExtension *From(Local<Object> proxy);
+
+  // the object a forwarding proxy falls back to
+  NAN_INLINE Local<Object> Target() {
+    return handle()->GetInternalField(kTargetField)->ToObject();
+  }
+
+  // the get results of a cached proxy, indexed by cache slot
+  NAN_INLINE Local<Array> CachedValues() {
+    return Local<Array>::Cast(handle()->GetInternalField(kCacheField));
+  }
+
+  // the typed array behind a proxy made by createArrayView
+  NAN_INLINE Local<Value> View() {
+    return handle()->GetInternalField(kViewField);
+  }
+
+  NAN_INLINE bool GetElement(uint32_t index, double *value) {
+    return ArrayView::Get(elements, View(), index, value);
+  }
+
+  NAN_INLINE bool SetElement(uint32_t index, double value) {
+    return ArrayView::Set(elements, View(), index, value);
+  }
+
+  NAN_INLINE uint32_t ElementCount() {
+    return ArrayView::Length(elements, View());
+  }
+
+  // the first byte of a proxy made by createStruct, or NULL
+  // when the buffer no longer holds every field
+  NAN_INLINE uint8_t *Struct() {
+    Nan::TypedArrayContents<uint8_t> bytes(View());
+
+    if (*bytes == NULL ||
+        bytes.length() < static_cast<size_t>(byteOffset) + layout->size()) {
+      return NULL;
+    }
+
+    return reinterpret_cast<uint8_t *>(*bytes) + byteOffset;
+  }
+
+  void StartCache(uint32_t maxEntries, uint64_t ttl);
+  bool Recall(const PropertyName &name, Local<Value> *value);
+  void Remember(const PropertyName &name, Local<Value> value);
+  void Forget(const PropertyName &name);
+  void ForgetAll();
+
+  static const int kTargetField = 1;
+  static const int kCacheField = 2;
+  static const int kViewField = 3;
+  static const int kLayoutField = 4;
+  static const int kStaticsField = 5;
+
+  // names of the ignore option the named interceptors never trap
+  NameSet ignore;
+  // the read-through cache of a proxy made by createCached, or NULL
+  ReadCache *cache;
+  // the query results of a proxy created with cacheQueries, or NULL
+  AttributeCache *attributes;
+  // the kind of typed array in kViewField
+  ArrayView::Kind elements;
+  // the fields of a proxy made by createStruct, owned by the
+  // StructRecord in kLayoutField, or NULL
+  const StructLayout *layout;
+  uint32_t byteOffset;
+  bool trapsUnknown;
+  // names of the statics option, which are not trapped either,
+  // owned by the NameRecord in kStaticsField, or NULL
+  const NameSet *statics;
+};
+
 class NodeProxy {
+  friend class TrapScope;
+
   public:
   static Nan::Persistent<ObjectTemplate> ObjectCreator;
   static Nan::Persistent<ObjectTemplate> FunctionCreator;
   static void Init(Handle<Object> target);
+  static NAN_INLINE Local<String> Key(ProxyKey key);
 
   protected:
   NodeProxy();
   ~NodeProxy();
+  static ProxyIsolateData *Isolates;
+  static void InitKeys();
+  static NAN_INLINE ProxyIsolateData *IsolateData();
+  static Local<ObjectTemplate> BuildTemplate(uint32_t shape);
+  static Local<ObjectTemplate> Template(uint32_t shape);
+  static uint32_t ShapeOf(HandlerRecord *record, const ProxyOptions &options);
+  static bool ReadOptions(Local<Value> value, ProxyOptions *options);
+  static uint32_t Extend(Local<Object> proxy, const ProxyOptions &options);
+  static void DefineStatics(Local<Object> proxy, const ProxyOptions &options);
+  static NAN_INLINE bool Bypasses(Local<Object> proxy, Local<String> property);
+  static NAN_INLINE bool Bypasses(Local<Object> proxy, uint32_t index);
+  static NAN_INLINE Local<Object> ForwardTarget(Local<Object> proxy);
+  static NAN_INLINE bool Forwards(Local<Object> proxy, Local<Value> result);
+  static NAN_INLINE ProxyExtension *Caching(Local<Object> proxy,
+              uint32_t caches = kStateCaching);
+  static NAN_INLINE Local<Value> Remember(ProxyExtension *caching,
+              Local<String> property, Local<Value> value);
+  static NAN_INLINE Local<Value> Remember(ProxyExtension *caching,
+              uint32_t index, Local<Value> value);
+  static NAN_INLINE Local<Integer> RememberQuery(ProxyExtension *caching,
+              Local<String> property, Local<Integer> attributes);
+  static NAN_INLINE Local<Integer> RememberQuery(ProxyExtension *caching,
+              uint32_t index, Local<Integer> attributes);
+  static NAN_INLINE void Invalidate(Local<Object> proxy, Local<String> property);
+  static NAN_INLINE void Invalidate(Local<Object> proxy, uint32_t index);
+  static NAN_INLINE ProxyExtension *Viewing(Local<Object> proxy);
+  static NAN_INLINE ProxyExtension *Structured(Local<Object> proxy);
+  static bool IndexRange(Local<Object> proxy, HandlerRecord *record,
+              uint32_t *start, uint32_t *end);
+  static NAN_INLINE bool ArrayLength(Local<Object> proxy, HandlerRecord *record,
+              Local<String> property, Local<Value> *length);
+  static NAN_INLINE Local<Value> ReadField(ProxyExtension *ext,
+              const StructLayout::Field &field);
+  static NAN_INLINE void WriteField(ProxyExtension *ext,
+              const StructLayout::Field &field, Local<Value> value);
+  static Local<Array> StructNames(ProxyExtension *ext, Local<Object> proxy);
+  static bool CollectNames(Local<Value> result, Local<Array> *names);
+  static HandlerRecord *BulkRecord(Local<Object> obj, ProxyTrap trap);
+  static void Materialize(Local<Object> proxy, Local<Object> pieces, uint32_t state);
+  static Local<Value> PlainCopy(Local<Object> proxy, Local<Object> pieces, ProxyLock lock);
+  static PropertyAttribute MaterializedAttributes(Local<Object> pd, uint32_t state);
+#if PROXY_NODE_VERSION_AT_LEAST(4, 0, 0)
+  static void NamedGetterThunk(Local<Name> property,
+              const PropertyCallbackInfo<Value> &info);
+  static void NamedSetterThunk(Local<Name> property, Local<Value> value,
+              const PropertyCallbackInfo<Value> &info);
+  static void NamedQueryThunk(Local<Name> property,
+              const PropertyCallbackInfo<Integer> &info);
+  static void NamedDeleterThunk(Local<Name> property,
+              const PropertyCallbackInfo<Boolean> &info);
+  static void NamedEnumeratorThunk(const PropertyCallbackInfo<Array> &info);
+#endif
+  static NAN_INLINE uint32_t GetState(Local<Object> proxy);
+  static NAN_INLINE void SetState(Local<Object> proxy, uint32_t state);
+  static NAN_INLINE uint32_t LockState(ProxyLock lock, uint32_t state);
   static Local<Integer>
     GetPropertyAttributeFromPropertyDescriptor(Local<Object> pd);
   static Local<Value> CorrectPropertyDescriptor(Local<Object> pd);
@@ -67,9 +651,26 @@ class NodeProxy {
   static NAN_METHOD(Create);
   static NAN_METHOD(SetPrototype);
   static NAN_METHOD(CreateFunction);
+  static NAN_METHOD(CreateForwarding);
+  static NAN_METHOD(CreateCached);
+  static NAN_METHOD(CreateArrayView);
+  static NAN_METHOD(CreateStruct);
   static NAN_METHOD(Freeze);
   static NAN_METHOD(IsLocked);
   static NAN_METHOD(IsProxy);
+  static NAN_METHOD(RefreshHandler);
+  static NAN_METHOD(EnableStats);
+  static NAN_METHOD(Stats);
+  static NAN_METHOD(ResetStats);
+  static NAN_METHOD(EnableTrace);
+  static NAN_METHOD(DumpTrace);
+  static NAN_METHOD(TrackHotKeys);
+  static NAN_METHOD(HotKeys);
+  static NAN_METHOD(CacheStats);
+  static NAN_METHOD(ClearCache);
+  static NAN_METHOD(GetMany);
+  static NAN_METHOD(SetMany);
+  static HandlerRecord *RecordOf(Local<Value> proxyOrHandler);
   static NAN_METHOD(GetOwnPropertyDescriptor);
   static NAN_METHOD(DefineProperty);
   static NAN_METHOD(DefineProperties);
@@ -83,6 +684,7 @@ class NodeProxy {
   static NAN_INDEX_SETTER(SetIndexedProperty);
   static NAN_INDEX_QUERY(QueryIndexedPropertyInteger);
   static NAN_INDEX_DELETER(DeleteIndexedProperty);
+  static NAN_INDEX_ENUMERATOR(EnumerateIndexedProperties);
 
   static NAN_INLINE Local<Value> CallPropertyDescriptorGet(Local<Value> descriptor,
               Handle<Object> context,
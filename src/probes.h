@@ -0,0 +1,80 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#ifndef NODE_PROXY_PROBES_H // NOLINT
+#define NODE_PROXY_PROBES_H
+
+/**
+ *  USDT probes fired at the entry and exit of the interceptors,
+ *  for perf and bpftrace:
+ *
+ *    nodeproxy:trap__entry(int trap, const char *name, size_t length, void *handler)
+ *    nodeproxy:trap__exit(int trap, void *handler)
+ *
+ *  trap is a ProxyIntercept, name is the UTF-8 property name or the
+ *  index in decimal, and handler identifies the HandlerRecord.
+ *  The probes are guarded by semaphores, so nothing is computed for
+ *  them unless a tracer is attached.
+ *  Without sys/sdt.h, or with NODE_PROXY_NO_SDT defined, they compile away.
+ */
+
+#if !defined(NODE_PROXY_NO_SDT) && defined(__linux__) && defined(__has_include)
+# if __has_include(<sys/sdt.h>)
+#  define NODE_PROXY_HAVE_SDT 1
+# endif
+#endif
+
+#if NODE_PROXY_HAVE_SDT
+# define _SDT_HAS_SEMAPHORES 1
+# include <sys/sdt.h>
+
+extern "C" {
+extern unsigned short nodeproxy_trap__entry_semaphore;
+extern unsigned short nodeproxy_trap__exit_semaphore;
+}
+
+# define PROXY_TRAP_ENTRY_ENABLED() \
+    __builtin_expect(nodeproxy_trap__entry_semaphore != 0, 0)
+# define PROXY_TRAP_EXIT_ENABLED() \
+    __builtin_expect(nodeproxy_trap__exit_semaphore != 0, 0)
+# define PROXY_TRAP_ENTRY(trap, name, length, handler) \
+    DTRACE_PROBE4(nodeproxy, trap__entry, trap, name, length, handler)
+# define PROXY_TRAP_EXIT(trap, handler) \
+    DTRACE_PROBE2(nodeproxy, trap__exit, trap, handler)
+#else
+# define PROXY_TRAP_ENTRY_ENABLED() 0
+# define PROXY_TRAP_EXIT_ENABLED() 0
+# define PROXY_TRAP_ENTRY(trap, name, length, handler)
+# define PROXY_TRAP_EXIT(trap, handler)
+#endif
+
+#define PROXY_PROBES_ENABLED() \
+    (PROXY_TRAP_ENTRY_ENABLED() || PROXY_TRAP_EXIT_ENABLED())
+
+#endif // NODE_PROXY_PROBES_H // NOLINT
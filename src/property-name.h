@@ -0,0 +1,147 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#ifndef NODE_PROXY_PROPERTY_NAME_H // NOLINT
+#define NODE_PROXY_PROPERTY_NAME_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include <v8.h>
+
+/**
+ *  The UTF-8 bytes and hash of a property name, used to probe
+ *  the native tables kept by the interceptors.
+ *  Names up to kInlineLength bytes are copied onto the stack,
+ *  so probing a table does not touch the heap.
+ */
+class PropertyName {
+  public:
+  static const int kInlineLength = 64;
+
+  explicit PropertyName(v8::Local<v8::String> name) {
+    int length = name->Utf8Length();
+
+    if (length <= kInlineLength) {
+      data_ = inline_;
+    } else {
+      heap_.resize(length);
+      data_ = &heap_[0];
+    }
+
+    name->WriteUtf8(data_, length, NULL, v8::String::NO_NULL_TERMINATION);
+    length_ = static_cast<size_t>(length);
+    hash_ = Hash(data_, length_);
+  }
+
+  // the name of an indexed property, as a string
+  explicit PropertyName(uint32_t index) {
+    data_ = inline_;
+    length_ = static_cast<size_t>(snprintf(inline_, kInlineLength, "%u", index));
+    hash_ = Hash(data_, length_);
+  }
+
+  // FNV-1a
+  static inline uint32_t Hash(const char *data, size_t length,
+                              uint32_t seed = 2166136261u) {
+    uint32_t hash = seed;
+
+    for (size_t i = 0; i < length; ++i) {
+      hash ^= static_cast<unsigned char>(data[i]);
+      hash *= 16777619u;
+    }
+
+    return hash;
+  }
+
+  inline const char *data() const { return data_; }
+  inline size_t length() const { return length_; }
+  inline uint32_t hash() const { return hash_; }
+
+  inline bool Equals(const char *data, size_t length) const {
+    return length == length_ && memcmp(data, data_, length) == 0;
+  }
+
+  private:
+  char inline_[kInlineLength];
+  std::string heap_;
+  char *data_;
+  size_t length_;
+  uint32_t hash_;
+};
+
+/**
+ *  A set of property names kept sorted by hash,
+ *  so a lookup is a binary search on the hash
+ *
+ */
+class NameSet {
+  public:
+  inline void Add(const char *data, size_t length) {
+    Entry entry;
+    entry.hash = PropertyName::Hash(data, length);
+    entry.name.assign(data, length);
+    entries_.insert(std::upper_bound(entries_.begin(), entries_.end(), entry,
+                                     ByHash), entry);
+  }
+
+  inline bool Contains(const PropertyName &name) const {
+    Entry probe;
+    probe.hash = name.hash();
+
+    for (std::vector<Entry>::const_iterator it = std::lower_bound(
+             entries_.begin(), entries_.end(), probe, ByHash);
+         it != entries_.end() && it->hash == probe.hash; ++it) {
+      if (name.Equals(it->name.data(), it->name.length())) {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  inline bool Empty() const { return entries_.empty(); }
+
+  private:
+  struct Entry {
+    uint32_t hash;
+    std::string name;
+  };
+
+  static inline bool ByHash(const Entry &a, const Entry &b) {
+    return a.hash < b.hash;
+  }
+
+  std::vector<Entry> entries_;
+};
+
+#endif // NODE_PROXY_PROPERTY_NAME_H // NOLINT
@@ -0,0 +1,288 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+#ifndef NODE_PROXY_READ_CACHE_H // NOLINT
+#define NODE_PROXY_READ_CACHE_H
+
+#include <stdint.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./property-name.h"
+
+/**
+ *  A least recently used map from property names to slots,
+ *  for the get results a cached proxy remembers.
+ *  The values themselves are kept by the caller, in an array
+ *  indexed by slot, so that the GC can see them.
+ *  Memory is fixed when it is created: capacity entries,
+ *  at most kMaxCapacity, and twice as many hash buckets.
+ */
+class ReadCache {
+  public:
+  static const uint32_t kNone = 0xffffffff;
+
+  // the largest capacity, callers reject anything above it
+  static const uint32_t kMaxCapacity = 1 << 20;
+
+  // ttl in nanoseconds, 0 for entries that never expire
+  ReadCache(uint32_t capacity, uint64_t ttl)
+      : capacity_(capacity < kMaxCapacity ? capacity : kMaxCapacity), ttl_(ttl), size_(0),
+        head_(kNone), tail_(kNone), hits_(0), misses_(0), evictions_(0),
+        entries_(capacity_) {
+    uint32_t buckets = 1;
+
+    while (buckets < capacity_ * 2) {
+      buckets <<= 1;
+    }
+
+    buckets_.assign(buckets, static_cast<uint32_t>(kNone));
+    Clear();
+  }
+
+  // the slot remembered for name, or kNone on a miss
+  uint32_t Find(const PropertyName &name, uint64_t now) {
+    uint32_t slot = Lookup(name);
+
+    if (slot != kNone && ttl_ != 0 && now >= entries_[slot].expires) {
+      Unlink(slot);
+      Release(slot);
+      slot = kNone;
+    }
+
+    if (slot == kNone) {
+      ++misses_;
+      return kNone;
+    }
+
+    ++hits_;
+    Unlink(slot);
+    PushFront(slot);
+
+    return slot;
+  }
+
+  // the slot to remember name in, evicting the least recently used
+  uint32_t Insert(const PropertyName &name, uint64_t now) {
+    uint32_t slot = Lookup(name);
+
+    if (slot != kNone) {
+      Unlink(slot);
+    } else if (free_ != kNone) {
+      slot = free_;
+      free_ = entries_[slot].chain;
+      ++size_;
+      Hash(slot, name);
+    } else {
+      slot = tail_;
+      Unlink(slot);
+      Unchain(slot);
+      ++evictions_;
+      Hash(slot, name);
+    }
+
+    entries_[slot].expires = now + ttl_;
+    PushFront(slot);
+
+    return slot;
+  }
+
+  // the slot name was remembered in, now free, or kNone
+  uint32_t Remove(const PropertyName &name) {
+    uint32_t slot = Lookup(name);
+
+    if (slot != kNone) {
+      Unlink(slot);
+      Release(slot);
+    }
+
+    return slot;
+  }
+
+  void Clear() {
+    std::fill(buckets_.begin(), buckets_.end(), static_cast<uint32_t>(kNone));
+    size_ = 0;
+    head_ = tail_ = kNone;
+    free_ = capacity_ ? 0 : kNone;
+
+    for (uint32_t i = 0; i < capacity_; ++i) {
+      entries_[i].name.clear();
+      entries_[i].chain = i + 1 < capacity_ ? i + 1 : kNone;
+    }
+  }
+
+  inline uint32_t capacity() const { return capacity_; }
+  inline uint32_t size() const { return size_; }
+  inline uint64_t ttl() const { return ttl_; }
+  inline double hits() const { return hits_; }
+  inline double misses() const { return misses_; }
+  inline double evictions() const { return evictions_; }
+
+  private:
+  struct Entry {
+    std::string name;
+    uint32_t hash;
+    uint64_t expires;
+    // the next entry in the same bucket, or in the free list
+    uint32_t chain;
+    // neighbours in recency order, most recent first
+    uint32_t prev;
+    uint32_t next;
+  };
+
+  inline uint32_t &Bucket(uint32_t hash) {
+    return buckets_[hash & (buckets_.size() - 1)];
+  }
+
+  uint32_t Lookup(const PropertyName &name) {
+    for (uint32_t slot = Bucket(name.hash()); slot != kNone; slot = entries_[slot].chain) {
+      if (entries_[slot].hash == name.hash() &&
+          name.Equals(entries_[slot].name.data(), entries_[slot].name.length())) {
+        return slot;
+      }
+    }
+
+    return kNone;
+  }
+
+  void Hash(uint32_t slot, const PropertyName &name) {
+    uint32_t &bucket = Bucket(name.hash());
+
+    entries_[slot].name.assign(name.data(), name.length());
+    entries_[slot].hash = name.hash();
+    entries_[slot].chain = bucket;
+    bucket = slot;
+  }
+
+  void Unchain(uint32_t slot) {
+    uint32_t *link = &Bucket(entries_[slot].hash);
+
+    while (*link != slot) {
+      link = &entries_[*link].chain;
+    }
+
+    *link = entries_[slot].chain;
+  }
+
+  void Release(uint32_t slot) {
+    Unchain(slot);
+    entries_[slot].name.clear();
+    entries_[slot].chain = free_;
+    free_ = slot;
+    --size_;
+  }
+
+  void PushFront(uint32_t slot) {
+    entries_[slot].prev = kNone;
+    entries_[slot].next = head_;
+
+    if (head_ != kNone) {
+      entries_[head_].prev = slot;
+    }
+
+    head_ = slot;
+
+    if (tail_ == kNone) {
+      tail_ = slot;
+    }
+  }
+
+  void Unlink(uint32_t slot) {
+    Entry &entry = entries_[slot];
+
+    if (entry.prev != kNone) {
+      entries_[entry.prev].next = entry.next;
+    } else {
+      head_ = entry.next;
+    }
+
+    if (entry.next != kNone) {
+      entries_[entry.next].prev = entry.prev;
+    } else {
+      tail_ = entry.prev;
+    }
+  }
+
+  uint32_t capacity_;
+  uint64_t ttl_;
+  uint32_t size_;
+  uint32_t head_;
+  uint32_t tail_;
+  uint32_t free_;
+  double hits_;
+  double misses_;
+  double evictions_;
+  std::vector<Entry> entries_;
+  std::vector<uint32_t> buckets_;
+};
+
+/**
+ *  The property attributes a query trap reported for each
+ *  name, or kAbsent, in a ReadCache whose entries never expire
+ *
+ */
+class AttributeCache {
+  public:
+  static const int32_t kAbsent = -1;
+
+  explicit AttributeCache(uint32_t capacity)
+      : names_(capacity, 0), attributes_(names_.capacity(), kAbsent) {}
+
+  inline bool Find(const PropertyName &name, int32_t *attributes) {
+    uint32_t slot = names_.Find(name, 0);
+
+    if (slot == ReadCache::kNone) {
+      return false;
+    }
+
+    *attributes = attributes_[slot];
+
+    return true;
+  }
+
+  inline void Insert(const PropertyName &name, int32_t attributes) {
+    attributes_[names_.Insert(name, 0)] = attributes;
+  }
+
+  inline void Remove(const PropertyName &name) {
+    names_.Remove(name);
+  }
+
+  inline void Clear() {
+    names_.Clear();
+  }
+
+  inline const ReadCache &names() const { return names_; }
+
+  private:
+  ReadCache names_;
+  std::vector<int32_t> attributes_;
+};
+
+#endif // NODE_PROXY_READ_CACHE_H // NOLINT
@@ -0,0 +1,361 @@
+/**
+ *
+ *
+ *
+ *  @copyright Copyright (c) 2009 Sam Shull <http://samshull.blogspot.com/>
+ *  @license <http://www.opensource.org/licenses/mit-license.html>
+ *
+ *  Permission is hereby granted, free of charge, to any person obtaining a copy
+ *  of this software and associated documentation files (the "Software"), to deal
+ *  in the Software without restriction, including without limitation the rights
+ *  to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ *  copies of the Software, and to permit persons to whom the Software is
+ *  furnished to do so, subject to the following conditions:
+ *
+ *  The above copyright notice and this permission notice shall be included in
+ *  all copies or substantial portions of the Software.
+ *
+ *  THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ *  IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ *  FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ *  AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ *  LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ *  OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ *  THE SOFTWARE.
+ *
+ *
+ *  CHANGES:
+ */
+
+
+#ifndef NODE_PROXY_STRUCT_LAYOUT_H // NOLINT
+#define NODE_PROXY_STRUCT_LAYOUT_H
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <string>
+#include <vector>
+#include "./property-name.h"
+#include "./array-view.h"
+
+/**
+ *  The fields of a schema given to createStruct, each with
+ *  the type and byte offset parsed from a spec like "f64@0",
+ *  "u32be@8" or "utf8[16]@12", and a perfect hash of their names
+ *  so that a lookup probes exactly one slot.
+ *
+ *  Numbers are little endian unless the type ends in "be".
+ */
+class StructLayout {
+  public:
+  enum Type {
+    kInt8 = 0,
+    kUint8,
+    kInt16,
+    kUint16,
+    kInt32,
+    kUint32,
+    kFloat32,
+    kFloat64,
+    kUtf8
+  };
+
+  struct Field {
+    std::string name;
+    uint32_t hash;
+    Type type;
+    uint32_t offset;
+    uint32_t size;
+    bool bigEndian;
+  };
+
+  StructLayout() : size_(0), bucketMask_(0), slotMask_(0) {}
+
+  // false when spec is not a valid "<type>@<offset>"
+  bool Add(const char *name, size_t length, const std::string &spec) {
+    Field field;
+    size_t at = spec.find('@');
+
+    if (at == std::string::npos || at == 0 ||
+        !ParseNumber(spec.substr(at + 1), &field.offset) ||
+        !ParseType(spec.substr(0, at), &field)) {
+      return false;
+    }
+
+    uint64_t end = static_cast<uint64_t>(field.offset) + field.size;
+
+    if (end > 0xffffffffu) {
+      return false;
+    }
+
+    field.name.assign(name, length);
+    field.hash = PropertyName::Hash(name, length);
+    fields_.push_back(field);
+    size_ = std::max(size_, static_cast<uint32_t>(end));
+
+    return true;
+  }
+
+  /**
+   *  Build the perfect hash once every field is added: the names are
+   *  split in buckets by hash, then each bucket, largest first, gets
+   *  the first seed that moves all of its names to free slots
+   *  Fails only when two names have the same hash
+   */
+  bool Seal() {
+    uint32_t count = static_cast<uint32_t>(fields_.size());
+    uint32_t buckets = 1, slots = 1;
+
+    while (buckets < (count + 1) / 2) buckets <<= 1;
+    while (slots < count * 2) slots <<= 1;
+
+    bucketMask_ = buckets - 1;
+    slotMask_ = slots - 1;
+    seeds_.assign(buckets, 0);
+    slots_.assign(slots, static_cast<int32_t>(kEmpty));
+
+    std::vector<std::vector<uint32_t> > members(buckets);
+
+    for (uint32_t i = 0; i < count; ++i) {
+      members[fields_[i].hash & bucketMask_].push_back(i);
+    }
+
+    std::vector<uint32_t> order(buckets);
+
+    for (uint32_t b = 0; b < buckets; ++b) {
+      order[b] = b;
+    }
+
+    std::stable_sort(order.begin(), order.end(), Larger(members));
+
+    for (uint32_t o = 0; o < buckets && !members[order[o]].empty(); ++o) {
+      const std::vector<uint32_t> &bucket = members[order[o]];
+      uint32_t seed = 0;
+
+      for (; seed < kMaxSeed; ++seed) {
+        if (Place(bucket, seed)) {
+          break;
+        }
+      }
+
+      if (seed == kMaxSeed) {
+        return false;
+      }
+
+      seeds_[order[o]] = seed;
+    }
+
+    return true;
+  }
+
+  inline const Field *Find(const PropertyName &name) const {
+    if (slots_.empty()) {
+      return NULL;
+    }
+
+    uint32_t seed = seeds_[name.hash() & bucketMask_];
+    int32_t i = slots_[Mix(name.hash(), seed) & slotMask_];
+
+    if (i == kEmpty) {
+      return NULL;
+    }
+
+    const Field &field = fields_[i];
+
+    return field.hash == name.hash() &&
+           name.Equals(field.name.data(), field.name.length()) ? &field : NULL;
+  }
+
+  // bytes from the start of a struct to the end of its last field
+  inline uint32_t size() const { return size_; }
+  inline const std::vector<Field> &fields() const { return fields_; }
+
+  // the value of a numeric field, data is the start of the struct
+  static double Read(const Field &field, const uint8_t *data) {
+    uint8_t bytes[8];
+    Load(field, data, bytes);
+
+    switch (field.type) {
+      case kInt8: return As<int8_t>(bytes);
+      case kUint8: return As<uint8_t>(bytes);
+      case kInt16: return As<int16_t>(bytes);
+      case kUint16: return As<uint16_t>(bytes);
+      case kInt32: return As<int32_t>(bytes);
+      case kUint32: return As<uint32_t>(bytes);
+      case kFloat32: return As<float>(bytes);
+      case kFloat64: return As<double>(bytes);
+      default: return 0;
+    }
+  }
+
+  // store a number with the conversions of the matching typed array
+  static void Write(const Field &field, uint8_t *data, double value) {
+    uint8_t bytes[8];
+
+    switch (field.type) {
+      case kInt8: From(static_cast<int8_t>(ArrayView::Wrap(value)), bytes); break;
+      case kUint8: From(static_cast<uint8_t>(ArrayView::Wrap(value)), bytes); break;
+      case kInt16: From(static_cast<int16_t>(ArrayView::Wrap(value)), bytes); break;
+      case kUint16: From(static_cast<uint16_t>(ArrayView::Wrap(value)), bytes); break;
+      case kInt32: From(static_cast<int32_t>(ArrayView::Wrap(value)), bytes); break;
+      case kUint32: From(ArrayView::Wrap(value), bytes); break;
+      case kFloat32: From(ArrayView::Narrow(value), bytes); break;
+      case kFloat64: From(value, bytes); break;
+      default: return;
+    }
+
+    Store(field, bytes, data);
+  }
+
+  // bytes of a utf8 field before its first NUL
+  static size_t TextLength(const Field &field, const uint8_t *data) {
+    const void *nul = memchr(data + field.offset, 0, field.size);
+
+    return nul == NULL ? field.size :
+        static_cast<const uint8_t *>(nul) - (data + field.offset);
+  }
+
+  // store text in a utf8 field, cut at a character boundary
+  // when too long and padded with NULs otherwise
+  static void WriteText(const Field &field, uint8_t *data,
+                        const char *text, size_t length) {
+    if (length > field.size) {
+      length = field.size;
+
+      while (length > 0 && (static_cast<uint8_t>(text[length]) & 0xc0) == 0x80) {
+        --length;
+      }
+    }
+
+    memcpy(data + field.offset, text, length);
+    memset(data + field.offset + length, 0, field.size - length);
+  }
+
+  private:
+  static const int32_t kEmpty = -1;
+  static const uint32_t kMaxSeed = 1 << 16;
+
+  struct Larger {
+    explicit Larger(const std::vector<std::vector<uint32_t> > &members)
+        : members_(members) {}
+    bool operator()(uint32_t a, uint32_t b) const {
+      return members_[a].size() > members_[b].size();
+    }
+    const std::vector<std::vector<uint32_t> > &members_;
+  };
+
+  static inline uint32_t Mix(uint32_t hash, uint32_t seed) {
+    uint32_t h = (hash ^ seed) * 2654435761u;
+    return h ^ (h >> 16);
+  }
+
+  // claim a slot for every field of a bucket, or none of them
+  bool Place(const std::vector<uint32_t> &bucket, uint32_t seed) {
+    for (size_t i = 0; i < bucket.size(); ++i) {
+      uint32_t slot = Mix(fields_[bucket[i]].hash, seed) & slotMask_;
+
+      if (slots_[slot] != kEmpty) {
+        for (size_t j = 0; j < i; ++j) {
+          slots_[Mix(fields_[bucket[j]].hash, seed) & slotMask_] = kEmpty;
+        }
+        return false;
+      }
+
+      slots_[slot] = static_cast<int32_t>(bucket[i]);
+    }
+
+    return true;
+  }
+
+  static bool ParseNumber(const std::string &text, uint32_t *value) {
+    if (text.empty() || text.size() > 10 ||
+        text.find_first_not_of("0123456789") != std::string::npos) {
+      return false;
+    }
+
+    uint64_t number = strtoull(text.c_str(), NULL, 10);
+
+    if (number > 0xffffffffu) {
+      return false;
+    }
+
+    *value = static_cast<uint32_t>(number);
+
+    return true;
+  }
+
+  static bool ParseType(std::string type, Field *field) {
+    field->bigEndian = false;
+
+    if (type.compare(0, 5, "utf8[") == 0 && type[type.size() - 1] == ']') {
+      field->type = kUtf8;
+      return ParseNumber(type.substr(5, type.size() - 6), &field->size) &&
+             field->size > 0;
+    }
+
+    if (type.size() > 2 && type.compare(type.size() - 2, 2, "be") == 0) {
+      field->bigEndian = true;
+      type.resize(type.size() - 2);
+    } else if (type.size() > 2 && type.compare(type.size() - 2, 2, "le") == 0) {
+      type.resize(type.size() - 2);
+    }
+
+    static const char *names[] = { "i8", "u8", "i16", "u16", "i32", "u32", "f32", "f64" };
+    static const uint32_t sizes[] = { 1, 1, 2, 2, 4, 4, 4, 8 };
+
+    for (int i = 0; i < kUtf8; ++i) {
+      if (type == names[i]) {
+        field->type = static_cast<Type>(i);
+        field->size = sizes[i];
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  static inline bool HostBigEndian() {
+    const uint16_t probe = 1;
+    return *reinterpret_cast<const uint8_t *>(&probe) == 0;
+  }
+
+  // copy the bytes of a field in host order, the struct may be unaligned
+  static inline void Load(const Field &field, const uint8_t *data, uint8_t *bytes) {
+    memcpy(bytes, data + field.offset, field.size);
+
+    if (field.bigEndian != HostBigEndian()) {
+      std::reverse(bytes, bytes + field.size);
+    }
+  }
+
+  static inline void Store(const Field &field, uint8_t *bytes, uint8_t *data) {
+    if (field.bigEndian != HostBigEndian()) {
+      std::reverse(bytes, bytes + field.size);
+    }
+
+    memcpy(data + field.offset, bytes, field.size);
+  }
+
+  template <typename T>
+  static inline double As(const uint8_t *bytes) {
+    T value;
+    memcpy(&value, bytes, sizeof(T));
+    return static_cast<double>(value);
+  }
+
+  template <typename T>
+  static inline void From(T value, uint8_t *bytes) {
+    memcpy(bytes, &value, sizeof(T));
+  }
+
+  std::vector<Field> fields_;
+  std::vector<uint32_t> seeds_;
+  std::vector<int32_t> slots_;
+  uint32_t size_;
+  uint32_t bucketMask_;
+  uint32_t slotMask_;
+};
+
+#endif // NODE_PROXY_STRUCT_LAYOUT_H // NOLINT
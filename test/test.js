@@ -221,6 +221,25 @@
           assert.equal(called, "callTrap", "callTrap was not last call");
         },
 
+        "proxy function forwards long argument lists": function() {
+          var args,
+              proxy = Proxy.createFunction({}, function() {
+                args = Array.prototype.slice.call(arguments);
+              });
+          proxy(1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20);
+          assert.equal(args.length, 20, "not all arguments were forwarded");
+          assert.equal(args[19], 20, "the last argument was not forwarded");
+        },
+
+        "proxy function uses the constructor trap": function() {
+          var constructed = false,
+              proxy = Proxy.createFunction({}, callTrap, function() {
+                constructed = true;
+              });
+          new proxy();
+          assert.ok(constructed, "constructor trap was not called");
+        },
+
         "proxy function instance property handling": function() {
           assert.ok("test" in proxyTrapTestInstance, "no 'test' in proxyTrapTestInstance");
           assert.equal(called, "has", "did not call has");
@@ -538,6 +557,788 @@
         "get hidden property on cloned object": function() {
           assert.ok(Proxy.hidden(clone, "hiddenTest") === regex, "unable to retrieve hidden property 'hiddenTest' on clone");
         },
+      },
+
+      "Handler records": {
+        "traps added after create are ignored until refreshHandler": function() {
+          var handler = {
+                getPropertyDescriptor: function(name) {
+                  return { value: "descriptor" };
+                }
+              },
+              proxy = Proxy.create(handler);
+          handler.get = function(receiver, name) {
+            return "get";
+          };
+          assert.equal(proxy.tester, "descriptor", "trap added after create was used");
+          assert.ok(Proxy.refreshHandler(proxy), "refreshHandler did not succeed");
+          assert.equal(proxy.tester, "get", "refreshHandler did not pick up the new trap");
+        },
+
+        "traps added after create only intercept proxies created afterwards": function() {
+          var deleted = [],
+              handler = {
+                get: function(receiver, name) {
+                  return "get";
+                }
+              },
+              proxy = Proxy.create(handler),
+              later;
+          handler["delete"] = function(name) {
+            deleted.push(name);
+            return true;
+          };
+          Proxy.refreshHandler(proxy);
+          delete proxy.tester;
+          assert.equal(deleted.length, 0, "an existing proxy gained a delete interceptor");
+          later = Proxy.create(handler);
+          delete later.tester;
+          assert.equal(deleted.join(), "tester", "a proxy created afterwards did not trap delete");
+        },
+
+        "proxies created from one handler share its traps": function() {
+          var handler = {
+                get: function(receiver, name) {
+                  return "first";
+                }
+              },
+              first = Proxy.create(handler),
+              second = Proxy.create(handler);
+          handler.get = function(receiver, name) {
+            return "second";
+          };
+          Proxy.refreshHandler(first);
+          assert.equal(second.tester, "second", "refreshHandler did not apply to every proxy of the handler");
+        },
+
+        "indexed only proxies leave named properties alone": function() {
+          var proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return "trapped";
+                }
+              }, undefined, { named: false });
+          assert.equal(proxy[0], "trapped", "indexed access was not trapped");
+          assert.equal(typeof proxy.toString, "function", "named access was trapped");
+        },
+
+        "keys trap is used when enumerate is missing": function() {
+          var proxy = Proxy.create({
+                keys: function() {
+                  return ["tester"];
+                }
+              });
+          assert.equal(Object.keys(proxy).join(), "tester", "keys trap was not used");
+        },
+
+        "enumeration traps may return an iterator of names or chunks": function() {
+          var chunks = [["a", "b"], "c", ["d"]],
+              proxy = Proxy.create({
+                keys: function() {
+                  var i = 0;
+                  return {
+                    size: 8,
+                    next: function() {
+                      return i < chunks.length ? { value: chunks[i++], done: false } : { done: true };
+                    }
+                  };
+                }
+              });
+          assert.equal(Object.keys(proxy).join(), "a,b,c,d", "iterator names were not collected");
+        },
+
+        "an iterator that throws stops the enumeration": function() {
+          var proxy = Proxy.create({
+                keys: function() {
+                  return {
+                    size: 0xffffffff,
+                    next: function() {
+                      throw new Error("next");
+                    }
+                  };
+                }
+              });
+          assert.throws(function() {
+            Object.keys(proxy);
+          }, /next/, "the exception thrown by next was swallowed");
+        },
+
+        "ignored names never reach the get trap": function() {
+          var trapped = [],
+              proxy = Proxy.create({
+                get: function(receiver, name) {
+                  trapped.push(name);
+                  return "trapped";
+                }
+              }, undefined, { ignore: ["then", "inspect"] });
+          assert.ok(proxy.then === undefined, "ignored name was trapped");
+          assert.equal(proxy.tester, "trapped", "other names were not trapped");
+          assert.equal(trapped.join(), "tester", "get trap saw an ignored name");
+        },
+
+        "non-masking proxies leave existing properties alone": function() {
+          var proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return "trapped";
+                }
+              }, { tester: "proto" }, { nonMasking: true });
+          assert.equal(proxy.tester, "proto", "existing property was trapped");
+          assert.equal(proxy.missing, "trapped", "missing property was not trapped");
+        },
+
+        "getValue and setValue are used before the descriptor traps": function() {
+          var store = {},
+              proxy = Proxy.create({
+                getValue: function(name) {
+                  return store[name];
+                },
+                setValue: function(name, value) {
+                  store[name] = value;
+                },
+                getPropertyDescriptor: function(name) {
+                  return { value: "descriptor" };
+                }
+              });
+          proxy.tester = 1;
+          proxy[0] = 2;
+          assert.equal(store.tester, 1, "named setValue was not used");
+          assert.equal(store[0], 2, "indexed setValue was not used");
+          assert.equal(proxy.tester, 1, "named getValue was not used");
+          assert.equal(proxy[0], 2, "indexed getValue was not used");
+        },
+
+        "statics are own properties resolved without the get trap": function() {
+          var trapped = [],
+              proxy = Proxy.create({
+                get: function(receiver, name) {
+                  trapped.push(name);
+                  return "trapped";
+                }
+              }, undefined, { statics: { version: "1.0.0" } });
+          assert.equal(proxy.version, "1.0.0", "static property was not installed");
+          assert.ok(Object.prototype.hasOwnProperty.call(proxy, "version"), "static property is not own");
+          assert.equal(proxy.missing, "trapped", "missing property was not trapped");
+          assert.equal(proxy.toString, "trapped", "inherited property was not trapped");
+          assert.equal(trapped.join(), "missing,toString", "get trap saw a static property");
+        },
+
+        "proxies sharing statics and ignore resolve both without the trap": function() {
+          var trapped = [],
+              statics = { version: "1.0.0", name: "shared" },
+              handler = {
+                get: function(receiver, name) {
+                  trapped.push(name);
+                  return "trapped";
+                }
+              },
+              first = Proxy.create(handler, undefined, { statics: statics }),
+              second = Proxy.create(handler, undefined, { statics: statics, ignore: ["then"] });
+          assert.equal(first.name, "shared", "static property of the first proxy was trapped");
+          assert.equal(second.version, "1.0.0", "static property of the second proxy was trapped");
+          assert.strictEqual(second.then, undefined, "ignored name was trapped");
+          assert.equal(first.then, "trapped", "ignore leaked to a proxy created without it");
+          assert.equal(trapped.join(), "then", "get trap saw a static or ignored name");
+        }
+      },
+
+      "Forwarding proxies": {
+        "missing traps forward to the target": function() {
+          var target = { tester: "target" },
+              proxy = Proxy.createForwarding(target, {});
+          assert.equal(proxy.tester, "target", "get was not forwarded");
+          proxy.other = "set";
+          assert.equal(target.other, "set", "set was not forwarded");
+          assert.ok("other" in proxy, "has was not forwarded");
+          assert.ok(delete proxy.other, "delete was not forwarded");
+          assert.ok(!("other" in target), "delete did not reach the target");
+          assert.equal(Object.keys(proxy).join(), "tester", "enumerate was not forwarded");
+        },
+
+        "traps returning Proxy.forward forward to the target": function() {
+          var proxy = Proxy.createForwarding({ tester: "target", other: "target" }, {
+                get: function(receiver, name) {
+                  return name === "tester" ? "trapped" : Proxy.forward;
+                }
+              });
+          assert.equal(proxy.tester, "trapped", "get trap was not used");
+          assert.equal(proxy.other, "target", "Proxy.forward did not forward the get");
+        },
+
+        "exceptions thrown by traps propagate": function() {
+          var proxy = Proxy.createForwarding({ tester: "target" }, {
+                get: function(receiver, name) {
+                  throw new Error("get failed");
+                },
+                has: function(name) {
+                  throw new Error("has failed");
+                }
+              });
+          assert.throws(function() {
+            return proxy.tester;
+          }, /get failed/, "named get did not throw");
+          assert.throws(function() {
+            return proxy[0];
+          }, /get failed/, "indexed get did not throw");
+          assert.throws(function() {
+            return "tester" in proxy;
+          }, /has failed/, "has did not throw");
+        },
+
+        "exceptions thrown by descriptor traps propagate": function() {
+          var proxy = Proxy.create({
+                getOwnPropertyDescriptor: function(name) {
+                  throw new Error("descriptor failed");
+                }
+              });
+          assert.throws(function() {
+            return "tester" in proxy;
+          }, /descriptor failed/, "named query did not throw");
+          assert.throws(function() {
+            return 0 in proxy;
+          }, /descriptor failed/, "indexed query did not throw");
+          assert.throws(function() {
+            proxy.tester = 1;
+          }, /descriptor failed/, "named set did not throw");
+          assert.throws(function() {
+            proxy[0] = 1;
+          }, /descriptor failed/, "indexed set did not throw");
+        }
+      },
+
+      "Array views": {
+        "elements are served from the typed array": function() {
+          var data = new Float64Array([1.5, 2.5]),
+              bytes = new Uint8ClampedArray(1),
+              trapped = [],
+              proxy = Proxy.createArrayView({
+                get: function(receiver, name) {
+                  trapped.push(String(name));
+                  return "trapped";
+                }
+              }, data);
+          assert.equal(proxy[0], 1.5, "element was not read from the view");
+          proxy[1] = 4;
+          assert.equal(data[1], 4, "element was not written to the view");
+          assert.ok(1 in proxy, "element was not found");
+          assert.ok(!(delete proxy[0]), "element was deleted");
+          assert.equal(proxy[2], "trapped", "index past the end was not trapped");
+          assert.equal(proxy.length, 2, "length was not the element count");
+          assert.equal(proxy.size, "trapped", "named property was not trapped");
+          assert.equal(trapped.join(), "2,size", "get trap saw an element");
+          proxy = Proxy.createArrayView({}, bytes);
+          proxy[0] = 300;
+          assert.equal(bytes[0], 255, "element was not converted like the view");
+        },
+
+        "float elements past the float range round like Float32Array": function() {
+          var floats = new Float32Array(3),
+              proxy = Proxy.createArrayView({}, floats);
+          proxy[0] = 1e39;
+          proxy[1] = -1e39;
+          proxy[2] = 3.4028235e38;
+          assert.equal(floats[0], Infinity, "large value did not round to Infinity");
+          assert.equal(floats[1], -Infinity, "large negative value did not round to -Infinity");
+          assert.equal(floats[2], Math.fround(3.4028235e38), "value near the limit was not rounded");
+        }
+      },
+
+      "Batched access": {
+        "getMany and setMany call the bulk traps once": function() {
+          var calls = 0,
+              store = { a: 1, b: 2 },
+              proxy = Proxy.create({
+                getMany: function(names) {
+                  ++calls;
+                  return names.map(function(name) {
+                    return store[name];
+                  });
+                },
+                setMany: function(entries) {
+                  ++calls;
+                  for (var name in entries) {
+                    store[name] = entries[name];
+                  }
+                },
+                get: function(receiver, name) {
+                  return store[name];
+                }
+              });
+          assert.ok(Proxy.setMany(proxy, { a: 3, c: 4 }), "setMany failed");
+          assert.equal(Proxy.getMany(proxy, ["a", "b", "c"]).join(), "3,2,4", "getMany returned the wrong values");
+          assert.equal(calls, 2, "bulk traps were not called once per batch");
+        },
+
+        "getMany and setMany fall back to the single traps": function() {
+          var store = {},
+              proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return store[name];
+                },
+                set: function(receiver, name, value) {
+                  store[name] = value;
+                  return true;
+                }
+              });
+          Proxy.setMany(proxy, { a: 1, b: 2 });
+          assert.equal(store.a + store.b, 3, "set trap did not see every entry");
+          assert.equal(Proxy.getMany(proxy, ["b", "a"]).join(), "2,1", "get trap did not see every name");
+        },
+
+        "getMany and setMany stop at the first throwing trap": function() {
+          var seen = [],
+              proxy = Proxy.create({
+                get: function(receiver, name) {
+                  seen.push(name);
+                  if (name === "bad") {
+                    throw new Error("get failed");
+                  }
+                  return name;
+                },
+                set: function(receiver, name, value) {
+                  seen.push(name);
+                  throw new Error("set failed");
+                }
+              });
+          assert.throws(function() {
+            Proxy.getMany(proxy, ["a", "bad", "c"]);
+          }, /get failed/, "getMany did not rethrow");
+          assert.equal(seen.join(), "a,bad", "getMany kept going after a throw");
+          seen = [];
+          assert.throws(function() {
+            Proxy.setMany(proxy, { a: 1, b: 2 });
+          }, /set failed/, "setMany did not rethrow");
+          assert.equal(seen.join(), "a", "setMany kept going after a throw");
+        }
+      },
+
+      "Array-like proxies": {
+        "indexRange is enumerated natively and gives the length": function() {
+          var gets = [],
+              proxy = Proxy.create({
+                indexRange: function() {
+                  return [0, 3];
+                },
+                get: function(receiver, name) {
+                  gets.push(name);
+                  return name === "label" ? "list" : Number(name) * 2;
+                },
+                keys: function() {
+                  return ["label"];
+                },
+                hasOwn: function(name) {
+                  return true;
+                }
+              });
+          assert.equal(proxy.length, 3, "length was not the end of the range");
+          assert.equal(Object.keys(proxy).join(), "0,1,2,label", "indices were not enumerated");
+          assert.equal(Array.prototype.join.call(proxy), "0,2,4", "array methods did not see the elements");
+          assert.ok(gets.indexOf("length") < 0, "length reached the get trap");
+        },
+
+        "the range follows a growing store": function() {
+          var calls = 0,
+              end = 2,
+              proxy = Proxy.create({
+                indexRange: function() {
+                  calls++;
+                  return [0, end];
+                }
+              });
+          assert.equal(proxy.length, 2, "length was not the end of the range");
+          end = 5;
+          assert.equal(proxy.length, 5, "length did not follow the range");
+          assert.equal(Object.keys(proxy).length, 5, "the indices did not follow the range");
+          assert.equal(calls, 3, "indexRange was not called on every read");
+        },
+
+        "ranges past the array length limit are rejected": function() {
+          var proxy = Proxy.create({
+                indexRange: function() {
+                  return [0, 0xffffffff];
+                }
+              });
+          assert.throws(function() {
+            Object.keys(proxy);
+          }, RangeError, "an oversized range was enumerated");
+          assert.throws(function() {
+            return proxy.length;
+          }, RangeError, "an oversized range was read as length");
+        }
+      },
+
+      "Structs": {
+        "fields are read and written in the buffer": function() {
+          var schema = { x: "f64@0", id: "u32be@8", name: "utf8[4]@12" },
+              buffer = new ArrayBuffer(24),
+              bytes = new Uint8Array(buffer),
+              trapped = [],
+              proxy = Proxy.createStruct(schema, buffer, 4, {
+                get: function(receiver, name) {
+                  trapped.push(name);
+                  return "trapped";
+                }
+              }),
+              bare = Proxy.createStruct(schema, buffer, 4);
+          proxy.x = 1.5;
+          proxy.id = -1;
+          proxy.name = "abcdef";
+          assert.equal(new DataView(buffer).getFloat64(4, true), 1.5, "f64 field was not written");
+          assert.equal(bytes[12], 255, "u32 field was not converted");
+          assert.equal(bare.id, 4294967295, "u32 field was not read");
+          assert.equal(bare.name, "abcd", "utf8 field was not cut to its length");
+          bare.name = "ab";
+          assert.equal(proxy.name, "ab", "utf8 field was not padded");
+          assert.ok("x" in proxy && !(delete proxy.x), "field was deleted");
+          assert.equal(Object.keys(bare).join(), "x,id,name", "fields were not enumerated");
+          assert.equal(proxy.other, "trapped", "unknown name was not trapped");
+          assert.equal(trapped.join(), "other", "get trap saw a field");
+          bare.other = 1;
+          assert.equal(bare.other, 1, "unknown name did not behave as on a plain object");
+          assert.throws(function() {
+            Proxy.createStruct({ x: "f64@20" }, buffer);
+          }, RangeError, "buffer shorter than the schema was accepted");
+          assert.throws(function() {
+            Proxy.createStruct({ x: "double@0" }, buffer);
+          }, TypeError, "invalid field type was accepted");
+        }
+      },
+
+      "Cached proxies": {
+        "get results are served from the cache until invalidated": function() {
+          var calls = 0,
+              store = { tester: 1 },
+              proxy = Proxy.createCached({
+                get: function(receiver, name) {
+                  ++calls;
+                  return store[name];
+                },
+                set: function(receiver, name, value) {
+                  store[name] = value;
+                  return true;
+                }
+              }, { maxEntries: 2 }),
+              stats;
+          assert.equal(proxy.tester, 1, "first get returned the wrong value");
+          assert.equal(proxy.tester, 1, "cached get returned the wrong value");
+          assert.equal(calls, 1, "cached get reached the handler");
+          proxy.tester = 2;
+          assert.equal(proxy.tester, 2, "set did not invalidate the cache");
+          proxy[0];
+          proxy[1];
+          stats = Proxy.cacheStats(proxy);
+          assert.equal(stats.hits, 1, "hits were not counted");
+          assert.equal(stats.misses, 4, "misses were not counted");
+          assert.equal(stats.evictions, 1, "least recently used entry was not evicted");
+          assert.equal(stats.size, 2, "cache grew past maxEntries");
+          assert.ok(Proxy.clearCache(proxy), "unable to clear the cache");
+          assert.equal(Proxy.cacheStats(proxy).size, 0, "cache was not cleared");
+        },
+
+        "exceptions thrown by the get trap are not cached": function() {
+          var fail = true,
+              proxy = Proxy.createCached({
+                get: function(receiver, name) {
+                  if (fail) {
+                    throw new Error("get failed");
+                  }
+                  return "value";
+                }
+              });
+          assert.throws(function() {
+            return proxy.tester;
+          }, /get failed/, "get did not throw");
+          assert.equal(Proxy.cacheStats(proxy).size, 0, "a failed get was cached");
+          fail = false;
+          assert.equal(proxy.tester, "value", "get after a failure was not trapped");
+        },
+
+        "cache sizes and lifetimes past the limits are rejected": function() {
+          assert.throws(function() {
+            Proxy.createCached({}, { maxEntries: 0x7fffffff });
+          }, RangeError, "an oversized cache was created");
+          assert.throws(function() {
+            Proxy.createCached({}, { ttlMs: Infinity });
+          }, RangeError, "an infinite ttl was accepted");
+          assert.equal(Proxy.cacheStats(Proxy.createCached({}, { maxEntries: 1 << 20 })).maxEntries,
+                       1 << 20, "the largest cache was not created");
+          assert.throws(function() {
+            Proxy.create({}, undefined, { cacheQueries: 0xffffffff });
+          }, RangeError, "an oversized query cache was created");
+        },
+
+        "query results are cached until a set or delete": function() {
+          var calls = 0,
+              store = { tester: 1 },
+              proxy = Proxy.create({
+                getOwnPropertyDescriptor: function(name) {
+                  ++calls;
+                  return name in store ? { value: store[name], enumerable: true } : undefined;
+                },
+                set: function(receiver, name, value) {
+                  store[name] = value;
+                  return true;
+                },
+                "delete": function(name) {
+                  return delete store[name];
+                }
+              }, undefined, { cacheQueries: true });
+          assert.ok("tester" in proxy, "existing property was not found");
+          assert.ok("tester" in proxy, "cached property was not found");
+          assert.ok(!("other" in proxy), "missing property was found");
+          assert.ok(!("other" in proxy), "cached missing property was found");
+          assert.equal(calls, 2, "cached queries reached the handler");
+          proxy.other = 1;
+          assert.ok("other" in proxy, "set did not invalidate the query cache");
+          delete proxy.tester;
+          assert.ok(!("tester" in proxy), "delete did not invalidate the query cache");
+          assert.equal(Proxy.cacheStats(proxy).queries.hits, 2, "query hits were not counted");
+          assert.ok(!(7 in proxy), "missing element was found");
+          assert.ok(!(7 in proxy), "cached missing element was found");
+          assert.equal(calls, 5, "cached element queries reached the handler");
+        }
+      },
+
+      "Stats": {
+        "interceptor calls are counted per handler": function() {
+          var handler = {
+                getPropertyDescriptor: function(name) {
+                  return { value: name };
+                }
+              },
+              first = Proxy.create(handler),
+              second = Proxy.create(handler),
+              stats;
+          Proxy.enableStats(true);
+          first.tester;
+          second.tester;
+          Proxy.enableStats(false);
+          stats = Proxy.stats(handler);
+          assert.equal(stats.get.calls, 2, "get calls were not counted");
+          assert.equal(stats.get.paths.getPropertyDescriptor, 2, "get path was not counted");
+          assert.ok(Proxy.resetStats(first), "unable to reset stats");
+          assert.strictEqual(Proxy.stats(second), null, "stats were not reset");
+        },
+
+        "traced interceptor calls are dumped as trace events": function() {
+          var proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return name;
+                }
+              }),
+              events;
+          Proxy.enableTrace(true);
+          proxy.tester;
+          proxy[1];
+          Proxy.enableTrace(false);
+          events = JSON.parse(Proxy.dumpTrace()).traceEvents;
+          assert.equal(events.length, 2, "wrong number of trace events");
+          assert.equal(events[0].name, "get tester", "named get was not traced");
+          assert.equal(events[1].name, "get 1", "indexed get was not traced");
+          assert.equal(events[0].ph, "X", "trace event is not a complete event");
+          assert.equal(events[0].tid, events[1].tid, "one proxy was reported as two threads");
+        },
+
+        "nested calls are traced separately": function() {
+          var inner = Proxy.create({
+                get: function(receiver, name) {
+                  return name;
+                }
+              }),
+              outer = Proxy.create({
+                get: function(receiver, name) {
+                  return inner[name];
+                }
+              }),
+              events;
+          Proxy.enableTrace(true);
+          outer.tester;
+          Proxy.enableTrace(false);
+          events = JSON.parse(Proxy.dumpTrace()).traceEvents;
+          assert.equal(events.length, 2, "a nested call overwrote the outer one");
+          assert.notEqual(events[0].tid, events[1].tid, "two proxies were reported as one thread");
+          assert.ok(events[1].dur >= events[0].dur, "the outer call was not recorded last");
+        },
+
+        "calls overwritten in the trace are reported as dropped": function() {
+          var proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return name;
+                }
+              }),
+              trace, i;
+          Proxy.enableTrace(true);
+          for (i = 0; i < 5000; ++i) {
+            proxy.tester;
+          }
+          Proxy.enableTrace(false);
+          trace = JSON.parse(Proxy.dumpTrace());
+          assert.equal(trace.traceEvents.length + trace.otherData.dropped, 5000, "dropped calls were not counted");
+          assert.ok(trace.otherData.dropped > 0, "the ring buffer did not overflow");
+        },
+
+        "hot keys are counted for tracked handlers": function() {
+          var proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return name;
+                }
+              }),
+              hot, i;
+          assert.ok(Proxy.trackHotKeys(proxy, { size: 2 }), "unable to track hot keys");
+          for (i = 0; i < 10; ++i) {
+            proxy.hot;
+          }
+          proxy.cold;
+          hot = Proxy.hotKeys(proxy, 1);
+          assert.equal(hot.length, 1, "wrong number of hot keys");
+          assert.equal(hot[0].name, "hot", "wrong hot key");
+          assert.ok(hot[0].count >= 10, "hot key was undercounted");
+        },
+
+        "hot key sketches past the limits are rejected": function() {
+          var proxy = Proxy.create({});
+          assert.throws(function() {
+            Proxy.trackHotKeys(proxy, { width: 1 << 24, depth: 2 });
+          }, RangeError, "an oversized width * depth was accepted");
+          assert.throws(function() {
+            Proxy.trackHotKeys(proxy, { size: 1 << 20 });
+          }, RangeError, "an oversized size was accepted");
+        }
+      },
+
+      "ES backend": {
+        "legacy traps run on the built-in Proxy": function() {
+          var proxy, fn;
+          if (typeof global.Proxy !== "function") {
+            return;
+          }
+          proxy = Proxy.create({
+            getPropertyDescriptor: function(name) {
+              return { value: name, enumerable: true };
+            },
+            keys: function() {
+              return ["tester"];
+            },
+            fix: function() {
+              return { tester: { value: "fixed", enumerable: true } };
+            }
+          }, undefined, { backend: "es" });
+          fn = Proxy.createFunction({}, function(a) {
+            return a;
+          }, undefined, { backend: "es" });
+          assert.equal(Proxy.backend(proxy), "es", "proxy was not created on the ES backend");
+          assert.equal(proxy.other, "other", "get did not fall back to getPropertyDescriptor");
+          assert.deepEqual(Object.keys(proxy), ["tester"], "keys trap was not used");
+          assert.equal(fn(1), 1, "call trap was not called");
+          assert.ok(Proxy.freeze(proxy), "unable to freeze ES backed proxy");
+          assert.ok(!Proxy.isTrapping(proxy), "frozen ES backed proxy is still trapping");
+          assert.equal(proxy.tester, "fixed", "fixed descriptors were not applied");
+          assert.strictEqual(proxy.other, undefined, "handler was called after fix");
+        },
+
+        "options only the native backend implements are not dropped": function() {
+          var proxy;
+          if (typeof global.Proxy !== "function") {
+            return;
+          }
+          assert.throws(function() {
+            Proxy.create({}, undefined, { backend: "es", ignore: ["then"] });
+          }, TypeError, "the es backend dropped the ignore option");
+          assert.throws(function() {
+            Proxy.createFunction({}, function() {}, undefined, { backend: "es", named: false });
+          }, TypeError, "the es backend dropped the named option");
+          proxy = Proxy.create({}, undefined, { backend: "auto", cacheQueries: true });
+          assert.equal(Proxy.backend(proxy), "native", "auto chose a backend without cacheQueries");
+        },
+
+        "both backends dispatch the traps in the same order": function() {
+          var order = ["hasOwn", "getPropertyDescriptor", "getOwnPropertyDescriptor"],
+              backends = ["native", "es"],
+              calls = {},
+              log, proxy, name, i;
+          if (typeof global.Proxy !== "function") {
+            return;
+          }
+          function trap(name, result) {
+            return function() {
+              log.push(name);
+              return result;
+            };
+          }
+          for (i = 0; i < backends.length; ++i) {
+            log = calls[backends[i]] = [];
+            proxy = Proxy.create({
+              hasOwn: trap("hasOwn", true),
+              has: trap("has", true),
+              getPropertyDescriptor: trap("getPropertyDescriptor", { value: 1, writable: true }),
+              getOwnPropertyDescriptor: trap("getOwnPropertyDescriptor", { value: 1, writable: true }),
+              getOwnPropertyNames: trap("getOwnPropertyNames", ["own"]),
+              enumerate: trap("enumerate", ["tester"]),
+              keys: trap("keys", ["tester"])
+            }, undefined, { backend: backends[i] });
+            "tester" in proxy;
+            proxy.tester;
+            proxy.tester = 2;
+            for (name in proxy) {
+              log.push("in " + name);
+            }
+            assert.deepEqual(log.slice(0, 3), order, backends[i] + " dispatched has, get and set out of order");
+            assert.ok(log.indexOf("enumerate") >= 0, backends[i] + " did not enumerate through enumerate");
+            assert.ok(log.indexOf("keys") < 0 && log.indexOf("getOwnPropertyNames") < 0,
+                      backends[i] + " enumerated through a later trap");
+          }
+        }
+      },
+
+      "Lock state": {
+        "proxies sharing a handler are locked independently": function() {
+          var handler = {
+                fix: function() {
+                  return {};
+                }
+              },
+              first = Proxy.create(handler),
+              second = Proxy.create(handler);
+          assert.ok(Proxy.freeze(first), "unable to freeze first proxy");
+          assert.ok(Proxy.isFrozen(first), "first proxy is not frozen");
+          assert.ok(!Proxy.isFrozen(second), "second proxy was frozen along with the first");
+          assert.ok(Proxy.isTrapping(second), "second proxy stopped trapping");
+        },
+
+        "Proxy.preventExtensions on proxy object": function() {
+          var proxy = Proxy.create({
+                fix: function() {
+                  return {};
+                }
+              });
+          assert.ok(Proxy.isExtensible(proxy), "new proxy is not extensible");
+          assert.ok(Proxy.preventExtensions(proxy), "unable to prevent extensions");
+          assert.ok(!Proxy.isExtensible(proxy), "proxy is still extensible");
+          assert.ok(!Proxy.isSealed(proxy), "proxy was sealed by preventExtensions");
+        },
+
+        "materialized proxies own their fixed properties": function() {
+          var plain,
+              proxy = Proxy.create({
+                get: function(receiver, name) {
+                  return "trapped";
+                },
+                fix: function() {
+                  return {
+                    tester: { value: "fixed", writable: true, enumerable: true, configurable: true }
+                  };
+                }
+              }, undefined, { materialize: true });
+          assert.equal(proxy.tester, "trapped", "proxy did not trap before freezing");
+          assert.equal(proxy.toString, "trapped", "inherited name was not trapped before freezing");
+          plain = Proxy.freeze(proxy);
+          assert.ok(plain, "unable to freeze proxy");
+          assert.ok(Object.prototype.hasOwnProperty.call(proxy, "tester"), "fixed property was not materialized");
+          assert.equal(proxy.tester, "fixed", "materialized property has the wrong value");
+          proxy.tester = "changed";
+          assert.equal(proxy.tester, "fixed", "materialized property of a frozen proxy was writable");
+          assert.ok(!Proxy.isProxy(plain), "the plain copy is a proxy");
+          assert.equal(plain.tester, "fixed", "the plain copy has the wrong value");
+          assert.ok(Object.isFrozen(plain), "the plain copy was not frozen");
+        }
       }
     }, section, sectionName, test, testIndex, sectionIndex = 0, totalTests = 0, passedTests = 0, failedTests = 0;
 